@@ -0,0 +1,216 @@
+// Throughput of ComponentArray add/get/remove, compared against the previous
+// hash map based implementation, and the cost of spawning entities with a
+// heavyweight component.
+#include "Components/ECS.h"
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <random>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+namespace {
+
+// Component roughly the size of Transform
+struct BenchComponent {
+  float x = 0, y = 0, width = 0, height = 0;
+  float targetX = 0, targetY = 0, startX = 0, startY = 0;
+  float moveProgress = 0;
+  bool isMoving = false;
+
+  BenchComponent() = default;
+  BenchComponent(float x, float y) : x(x), y(y) {}
+};
+
+// Component that owns heap memory, like Sprite (animation list) or Dialogue.
+// Counts how often the storage relocates it.
+struct HeavyComponent {
+  static inline std::size_t moves = 0;
+
+  std::string name;
+  std::vector<int> frames;
+
+  explicit HeavyComponent(std::size_t i)
+      : name("component_" + std::to_string(i)), frames(16, int(i)) {}
+
+  HeavyComponent(HeavyComponent &&other) noexcept
+      : name(std::move(other.name)), frames(std::move(other.frames)) {
+    moves++;
+  }
+
+  HeavyComponent& operator=(HeavyComponent &&other) noexcept {
+    name = std::move(other.name);
+    frames = std::move(other.frames);
+    moves++;
+    return *this;
+  }
+};
+
+// The ComponentArray implementation before the sparse set storage was added,
+// kept here so both can be measured side by side
+template<typename T>
+class HashComponentArray {
+public:
+  T& addComponent(EntityId entityId, T &component) {
+    std::size_t index = components.size();
+    components.push_back(std::move(component));
+    entityToIndex[entityId] = index;
+    indexToEntity[index] = entityId;
+    return components[entityToIndex[entityId]];
+  }
+
+  T& getComponent(EntityId entityId) {
+      return components[entityToIndex[entityId]];
+  }
+
+  void removeComponent(EntityId entityId) {
+    if (!entityToIndex.contains(entityId)) {
+        return;
+    }
+
+    std::size_t indexToRemove = entityToIndex[entityId];
+    std::size_t lastIndex = components.size() - 1;
+
+    if (indexToRemove != lastIndex) {
+      components[indexToRemove] = std::move(components[lastIndex]);
+      EntityId lastEntityId = indexToEntity[lastIndex];
+      entityToIndex[lastEntityId] = indexToRemove;
+      indexToEntity[indexToRemove] = lastEntityId;
+    }
+
+    components.pop_back();
+    entityToIndex.erase(entityId);
+    indexToEntity.erase(lastIndex);
+  }
+
+private:
+    std::vector<T> components = {};
+    std::unordered_map<EntityId, std::size_t> entityToIndex = {};
+    std::unordered_map<std::size_t, EntityId> indexToEntity = {};
+};
+
+using Clock = std::chrono::steady_clock;
+
+template<typename Fn>
+double millisecondsFor(Fn &&fn) {
+  auto start = Clock::now();
+  fn();
+  std::chrono::duration<double, std::milli> elapsed = Clock::now() - start;
+  return elapsed.count();
+}
+
+struct Result {
+  double add;
+  double get;
+  double remove;
+};
+
+// Prevent the compiler from discarding the get loop
+volatile float sink = 0;
+
+Result benchHash(const std::vector<EntityId> &ids, const std::vector<EntityId> &order) {
+  HashComponentArray<BenchComponent> array;
+  Result result = {};
+
+  result.add = millisecondsFor([&] {
+    for (EntityId id : ids) {
+      BenchComponent component(float(id), 1.0f);
+      array.addComponent(id, component);
+    }
+  });
+  result.get = millisecondsFor([&] {
+    float sum = 0;
+    for (EntityId id : order)
+      sum += array.getComponent(id).x;
+    sink = sum;
+  });
+  result.remove = millisecondsFor([&] {
+    for (EntityId id : order)
+      array.removeComponent(id);
+  });
+
+  return result;
+}
+
+Result benchSparse(const std::vector<EntityId> &ids, const std::vector<EntityId> &order) {
+  ComponentArray<BenchComponent> array;
+  Result result = {};
+
+  result.add = millisecondsFor([&] {
+    for (EntityId id : ids)
+      array.addComponent(id, float(id), 1.0f);
+  });
+  result.get = millisecondsFor([&] {
+    float sum = 0;
+    for (EntityId id : order)
+      sum += array.getComponent(id).x;
+    sink = sum;
+  });
+  result.remove = millisecondsFor([&] {
+    for (EntityId id : order)
+      array.removeComponent(id);
+  });
+
+  return result;
+}
+
+/*
+ * Create entities and give each a Transform-sized and a heavyweight
+ * component, as loading a map does
+ */
+double benchSpawn(std::size_t count) {
+  EntityRegistry registry;
+  HeavyComponent::moves = 0;
+  return millisecondsFor([&] {
+    for (std::size_t i = 0; i < count; i++) {
+      EntityId entityId = registry.create();
+      registry.addComponent<BenchComponent>(entityId, float(i), 1.0f);
+      registry.addComponent<HeavyComponent>(entityId, i);
+    }
+  });
+}
+
+double opsPerSecond(std::size_t count, double ms) {
+  return ms > 0 ? double(count) / (ms / 1000.0) : 0;
+}
+
+void printRow(const char *name, std::size_t count, const Result &hash,
+              const Result &sparse, double Result::*field) {
+  std::printf("%-8s %12.2f %12.2f %14.0f %14.0f %8.1fx\n", name,
+              hash.*field, sparse.*field,
+              opsPerSecond(count, hash.*field),
+              opsPerSecond(count, sparse.*field),
+              sparse.*field > 0 ? hash.*field / sparse.*field : 0);
+}
+
+} // namespace
+
+int main() {
+  for (std::size_t count : {10'000u, 100'000u, 1'000'000u}) {
+    std::vector<EntityId> ids(count);
+    for (std::size_t i = 0; i < count; i++)
+      ids[i] = EntityId(i + 1);
+
+    // Access and remove in random order so neither version benefits from
+    // walking memory linearly
+    std::vector<EntityId> order = ids;
+    std::shuffle(order.begin(), order.end(), std::mt19937(42));
+
+    Result hash = benchHash(ids, order);
+    Result sparse = benchSparse(ids, order);
+
+    std::printf("\n%zu components\n", count);
+    std::printf("%-8s %12s %12s %14s %14s %9s\n", "op", "hash (ms)",
+                "sparse (ms)", "hash (ops/s)", "sparse (ops/s)", "speedup");
+    printRow("add", count, hash, sparse, &Result::add);
+    printRow("get", count, hash, sparse, &Result::get);
+    printRow("remove", count, hash, sparse, &Result::remove);
+
+    double spawn = benchSpawn(count);
+    std::printf("%-8s %12.2f ms %14.0f entities/s %12zu moves\n", "spawn",
+                spawn, opsPerSecond(count, spawn), HeavyComponent::moves);
+  }
+
+  return 0;
+}
@@ -0,0 +1,236 @@
+// EntityRegistry benchmark suite. Times the common registry operations at
+// several entity counts and writes the results as JSON, so runs from
+// different engine versions can be compared.
+//
+// Usage: pangolengine_bench [output.json]
+// Results go to stdout when no output file is given.
+#include "Components/ECS.h"
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <random>
+#include <string>
+#include <vector>
+
+#ifndef PANGOLENGINE_BENCH_REVISION
+#define PANGOLENGINE_BENCH_REVISION "unknown"
+#endif
+
+namespace {
+
+// Components sized like the engine's own: Position/Velocity are small and
+// trivially copyable, Health stands in for the rarer gameplay components
+struct Position {
+  float x = 0, y = 0;
+};
+
+struct Velocity {
+  float dx = 0, dy = 0;
+};
+
+struct Health {
+  int current = 100;
+  int max = 100;
+};
+
+using Clock = std::chrono::steady_clock;
+
+// Prevent the compiler from discarding read-only loops
+volatile float sink = 0;
+
+struct Measurement {
+  std::string name;
+  std::size_t entities = 0;
+  std::vector<double> samples = {}; // milliseconds, one per repetition
+};
+
+/*
+ * Run setup() then time body() once per repetition. Setup is excluded from
+ * the timing, so every repetition starts from the same state.
+ */
+template<typename Setup, typename Body>
+Measurement measure(const char *name, std::size_t entities,
+                    std::size_t repetitions, Setup setup, Body body) {
+  Measurement result = {name, entities};
+  for (std::size_t rep = 0; rep < repetitions; rep++) {
+    EntityRegistry registry;
+    std::vector<EntityId> ids = setup(registry);
+
+    auto start = Clock::now();
+    body(registry, ids);
+    std::chrono::duration<double, std::milli> elapsed = Clock::now() - start;
+    result.samples.push_back(elapsed.count());
+  }
+  return result;
+}
+
+std::vector<EntityId> createEntities(EntityRegistry &registry, std::size_t count) {
+  std::vector<EntityId> ids(count);
+  for (EntityId &id : ids)
+    id = registry.create();
+  return ids;
+}
+
+/*
+ * Every entity has a Position, every second one a Velocity and every third
+ * one a Health, so queries have to skip non-matching entities
+ */
+std::vector<EntityId> populate(EntityRegistry &registry, std::size_t count) {
+  std::vector<EntityId> ids = createEntities(registry, count);
+  for (std::size_t i = 0; i < count; i++) {
+    registry.addComponent<Position>(ids[i], float(i), 0.0f);
+    if (i % 2 == 0)
+      registry.addComponent<Velocity>(ids[i], 1.0f, 1.0f);
+    if (i % 3 == 0)
+      registry.addComponent<Health>(ids[i]);
+  }
+  return ids;
+}
+
+// Random access order, so no operation benefits from walking memory linearly
+void shuffle(std::vector<EntityId> &ids) {
+  std::shuffle(ids.begin(), ids.end(), std::mt19937(42));
+}
+
+std::vector<Measurement> runSuite(std::size_t count) {
+  // Keep the total work per size roughly constant
+  const std::size_t repetitions =
+      std::max<std::size_t>(3, std::size_t(1'000'000) / count);
+  std::vector<Measurement> results;
+
+  results.push_back(measure("create", count, repetitions,
+    [](EntityRegistry &) { return std::vector<EntityId>(); },
+    [&](EntityRegistry &registry, std::vector<EntityId> &) {
+      for (std::size_t i = 0; i < count; i++)
+        registry.create();
+    }));
+
+  results.push_back(measure("destroy", count, repetitions,
+    [&](EntityRegistry &registry) {
+      std::vector<EntityId> ids = populate(registry, count);
+      shuffle(ids);
+      return ids;
+    },
+    [](EntityRegistry &registry, std::vector<EntityId> &ids) {
+      for (EntityId id : ids)
+        registry.destroy(id);
+    }));
+
+  results.push_back(measure("add_component", count, repetitions,
+    [&](EntityRegistry &registry) { return createEntities(registry, count); },
+    [](EntityRegistry &registry, std::vector<EntityId> &ids) {
+      for (EntityId id : ids)
+        registry.addComponent<Position>(id, 1.0f, 2.0f);
+    }));
+
+  results.push_back(measure("remove_component", count, repetitions,
+    [&](EntityRegistry &registry) {
+      std::vector<EntityId> ids = populate(registry, count);
+      shuffle(ids);
+      return ids;
+    },
+    [](EntityRegistry &registry, std::vector<EntityId> &ids) {
+      for (EntityId id : ids)
+        registry.removeComponent<Position>(id);
+    }));
+
+  results.push_back(measure("get_component", count, repetitions,
+    [&](EntityRegistry &registry) {
+      std::vector<EntityId> ids = populate(registry, count);
+      shuffle(ids);
+      return ids;
+    },
+    [](EntityRegistry &registry, std::vector<EntityId> &ids) {
+      float sum = 0;
+      for (EntityId id : ids)
+        sum += registry.getComponent<Position>(id).x;
+      sink = sum;
+    }));
+
+  results.push_back(measure("view_2", count, repetitions,
+    [&](EntityRegistry &registry) { return populate(registry, count); },
+    [](EntityRegistry &registry, std::vector<EntityId> &) {
+      registry.view<Position, Velocity>().each(
+        [](EntityId, Position &position, Velocity &velocity) {
+          position.x += velocity.dx;
+          position.y += velocity.dy;
+        });
+    }));
+
+  results.push_back(measure("view_3", count, repetitions,
+    [&](EntityRegistry &registry) { return populate(registry, count); },
+    [](EntityRegistry &registry, std::vector<EntityId> &) {
+      float sum = 0;
+      registry.view<Position, Velocity, Health>().each(
+        [&](EntityId, Position &position, Velocity &, Health &health) {
+          sum += position.x * float(health.current);
+        });
+      sink = sum;
+    }));
+
+  results.push_back(measure("clear", count, repetitions,
+    [&](EntityRegistry &registry) { return populate(registry, count); },
+    [](EntityRegistry &registry, std::vector<EntityId> &) {
+      registry.clear();
+    }));
+
+  return results;
+}
+
+double median(std::vector<double> samples) {
+  std::sort(samples.begin(), samples.end());
+  std::size_t mid = samples.size() / 2;
+  return samples.size() % 2 ? samples[mid]
+                            : (samples[mid - 1] + samples[mid]) / 2;
+}
+
+void writeJson(std::FILE *out, const std::vector<Measurement> &results) {
+#ifdef PANGOLENGINE_ARCHETYPE_STORAGE
+  const char *storage = "archetype";
+#else
+  const char *storage = "sparse_set";
+#endif
+
+  std::fprintf(out, "{\n");
+  std::fprintf(out, "  \"revision\": \"%s\",\n", PANGOLENGINE_BENCH_REVISION);
+  std::fprintf(out, "  \"storage\": \"%s\",\n", storage);
+  std::fprintf(out, "  \"max_components\": %zu,\n", maxComponents);
+  std::fprintf(out, "  \"results\": [\n");
+  for (std::size_t i = 0; i < results.size(); i++) {
+    const Measurement &result = results[i];
+    double best = *std::min_element(result.samples.begin(), result.samples.end());
+    double mid = median(result.samples);
+    std::fprintf(out,
+                 "    {\"name\": \"%s\", \"entities\": %zu, \"repetitions\": %zu, "
+                 "\"min_ms\": %.4f, \"median_ms\": %.4f, \"ns_per_entity\": %.2f}%s\n",
+                 result.name.c_str(), result.entities, result.samples.size(),
+                 best, mid, mid * 1e6 / double(result.entities),
+                 i + 1 < results.size() ? "," : "");
+  }
+  std::fprintf(out, "  ]\n}\n");
+}
+
+} // namespace
+
+int main(int argc, char *argv[]) {
+  std::vector<Measurement> results;
+  for (std::size_t count : {1'000u, 10'000u, 100'000u, 1'000'000u}) {
+    std::fprintf(stderr, "Running %zu entities...\n", count);
+    std::vector<Measurement> suite = runSuite(count);
+    results.insert(results.end(), suite.begin(), suite.end());
+  }
+
+  std::FILE *out = stdout;
+  if (argc > 1) {
+    out = std::fopen(argv[1], "w");
+    if (!out) {
+      std::fprintf(stderr, "Could not open %s for writing\n", argv[1]);
+      return 1;
+    }
+  }
+
+  writeJson(out, results);
+  if (out != stdout)
+    std::fclose(out);
+  return 0;
+}
@@ -1,15 +1,17 @@
 #include "DemoGame.h"
 #include "Pangolengine.h"
+#include "DemoSystems.h"
 #include <filesystem>
 #include <iostream>
 #include <ostream>
 #include <stdexcept>
 #include <string>
+#include <utility>
 
 namespace fs = std::filesystem;
 
 DemoGame::DemoGame(Engine* engine)
-  : engine(engine), playerId(0), mapId(0) {}
+  : engine(engine), playerId(nullEntity), mapId(nullEntity) {}
 
 DemoGame::~DemoGame() {
   onCleanup();
@@ -22,12 +24,35 @@ bool DemoGame::onInitialise() {
   fs::path assetsPath = fs::path(SDL_GetBasePath()) / "assets";
   std::string entryMap = (assetsPath / "maps" / ENTRY_MAP).string();
 
+  // Release textures and sounds whenever a sprite, map or transition goes,
+  // whether it is destroyed on its own or along with the rest of its map
+  auto& registry = engine->getRegistry();
+  registry.onRemove<Sprite>([](EntityRegistry& registry, EntityId entity) {
+    registry.getComponent<Sprite>(entity).clean();
+  });
+  registry.onRemove<Map>([](EntityRegistry& registry, EntityId entity) {
+    registry.getComponent<Map>(entity).clean();
+  });
+  registry.onRemove<Transition>([](EntityRegistry& registry, EntityId entity) {
+    registry.getComponent<Transition>(entity).clean();
+  });
+
   // Set up map data
+  TextureManager::SetAtlas(&mapAtlas);
+  mapScope = registry.createScope();
   loadDemoMap();
 
   // Set up player character
   loadPlayer();
 
+  // Register per-frame systems. Interaction and animation only read
+  // transforms, so they run in parallel once movement has finished. The map
+  // has no per-frame update: it works out what the camera sees as it draws.
+  registry.trackChanges<Transform>();
+  engine->addSystem<MovementSystem>(registry, playerId);
+  engine->addSystem<InteractionSystem>(playerId);
+  engine->addSystem<AnimationSystem>();
+
   // Set up the UI manager (accessed via engine)
   engine->uiManager = new UIManager();
 
@@ -49,6 +74,7 @@ bool DemoGame::onInitialise() {
   std::cout << "Select dialogue option: arrow keys / mouse scroll"  << std::endl;
   std::cout << "Scroll dialogue box: W-A-S-D / mouse scroll"  << std::endl;
   std::cout << "Menu/back menu: ESC"  << std::endl;
+  std::cout << "Quick-save/quick-load: F5 / F9"  << std::endl;
   std::cout << "Enter menu: ENTER / mouse click"  << std::endl;
   std::cout << "Scroll menu: arrow keys / mouse wheel"  << std::endl;
   std::cout << "-------------------------------------------------" << std::endl;
@@ -58,6 +84,29 @@ bool DemoGame::onInitialise() {
 
 void DemoGame::onEvent(SDL_Event* event) {
   auto& registry = engine->getRegistry();
+
+  // Some renderers lose what was drawn into render targets, which includes
+  // the baked map chunks
+  if (event->type == SDL_EVENT_RENDER_TARGETS_RESET) {
+    registry.view<Map>().each([](EntityId, Map& map) { map.invalidate(); });
+    return;
+  }
+
+  // Quick-save and quick-load, outside of menus and dialogue
+  bool interacting = false;
+  for (auto [intEntity, interactable] : registry.view<Interactable>())
+    interacting = interacting || interactable.active;
+  if (event->type == SDL_EVENT_KEY_DOWN && !event->key.repeat &&
+      !engine->uiManager->isMenuActive() && !interacting) {
+    if (event->key.key == SDLK_F5) {
+      quickSave();
+      return;
+    }
+    if (event->key.key == SDLK_F9) {
+      quickLoad();
+      return;
+    }
+  }
   auto& keyboardController = registry.getComponent<KeyboardController>(playerId);
   auto& mouseController = registry.getComponent<MouseController>(playerId);
   auto& transform = registry.getComponent<Transform>(playerId);
@@ -65,10 +114,8 @@ void DemoGame::onEvent(SDL_Event* event) {
 
   // Iterate through interactable components to check
   // if any can be interacted with
-  auto interactEntities = registry.getEntitiesWithComponents<Interactable>();
   Interactable* intObject = nullptr;
-  for (auto intEntity : interactEntities) {
-    auto& interactable = registry.getComponent<Interactable>(intEntity);
+  for (auto [intEntity, interactable] : registry.view<Interactable>()) {
     if (interactable.canInteract) {
       intObject = &interactable;
       break; // only one object should be interactable at any one time
@@ -104,111 +151,74 @@ void DemoGame::onEvent(SDL_Event* event) {
 void DemoGame::onUpdate() {
   auto& registry = engine->getRegistry();
 
-  // Get player collider and transform components
+  // Movement, collision, interaction and animation updates run as systems
+  // before this (see DemoSystems.h)
   auto& playerCollider = registry.getComponent<Collider>(playerId);
   auto& playerTransform = registry.getComponent<Transform>(playerId);
   auto& playerController = registry.getComponent<KeyboardController>(playerId);
   auto& playerMouseController = registry.getComponent<MouseController>(playerId);
   auto& playerSprite = registry.getComponent<Sprite>(playerId);
 
-  // Update all colliders
-  auto colliderEntities = registry.getEntitiesWithComponents<Collider, Transform>();
-  for (auto entity : colliderEntities) {
-    auto& collider = registry.getComponent<Collider>(entity);
-    auto& transform = registry.getComponent<Transform>(entity);
-    transform.update();
-    collider.update(transform);
-  }
-
-  // Check for collision with player (if moving) and abort move on collision
-  if (playerTransform.isMoving) {
-    // Make a collider where the player will be at the end of the move
-    SDL_FRect futureCollider;
-    futureCollider.x = playerTransform.targetPosition.x + playerCollider.offset.x;
-    futureCollider.y = playerTransform.targetPosition.y + playerCollider.offset.y;
-    futureCollider.h = playerCollider.collider.h;
-    futureCollider.w = playerCollider.collider.w;
-
-    for (auto entity : colliderEntities) {
-      if (entity == playerId)
-        continue;
-
-      auto& collider = registry.getComponent<Collider>(entity);
-      if (Collision::AABB(futureCollider, collider.collider)) {
-        std::cout << "Player collision!" << std::endl;
-        playerTransform.abortMove();
-        break;
-      }
-    }
-  }
-
-  // Update all Interactable
-  auto interactEntities = registry.getEntitiesWithComponents<Interactable, Transform>();
+  // Find the object the player can interact with (if any)
   Interactable* intObject = nullptr;
   Dialogue* dialogue = nullptr;
-  for (auto entity : interactEntities) {
-    auto& interact = registry.getComponent<Interactable>(entity);
-    auto& transform = registry.getComponent<Transform>(entity);
-    interact.canInteract = false;
-    if (entity != playerId &&
-      Collision::AABB(playerCollider.collider, interact.interactArea)) {
-      interact.canInteract = true;
+  for (auto [entity, interact] : registry.view<Interactable>()) {
+    if (interact.canInteract) {
       intObject = &interact;
       dialogue = registry.tryGetComponent<Dialogue>(entity);
       if (! dialogue)
         throw std::runtime_error(
           "No dialogue component found for interaction entity"
         );
-    } else {
-      interact.canInteract = false;
+      break; // only one object should be interactable at any one time
     }
-    transform.update();
-    interact.update(transform);
-  }
-
-  // Update all sprites
-  auto spriteEntities = registry.getEntitiesWithComponents<Sprite, Transform>();
-  for (auto entity : spriteEntities) {
-    auto& sprite = registry.getComponent<Sprite>(entity);
-    auto& transform = registry.getComponent<Transform>(entity);
-    sprite.update(transform);
   }
 
-  // Update maps
-  auto mapEntities = registry.getEntitiesWithComponents<Map>();
-  for (auto mapEntity : mapEntities) {
-    auto& map = registry.getComponent<Map>(mapEntity);
-    map.update();
-  }
-
-  // Update all transitions
-  auto transitionEntities = registry.getEntitiesWithComponents<Transition, Transform>();
-  for (auto entity : transitionEntities) {
-    auto& transition = registry.getComponent<Transition>(entity);
-    auto& transform = registry.getComponent<Transform>(entity);
-
-    transform.update();
-    transition.update(transform);
+  // Keep transitions in sync with any transforms that changed
+  registry.eachChanged<Transform>(transitionVersion,
+    [&](EntityId entity, Transform& transform) {
+      if (Transition* transition = registry.tryGetComponent<Transition>(entity))
+        transition->update(transform);
+    });
+  transitionVersion = registry.changeVersion();
 
+  // Check for transitions. Switching maps restructures the registry, so only
+  // note which transition fired here and switch once iteration is done.
+  std::string transitionMapPath = "";
+  for (auto [entity, transition] : registry.view<Transition>()) {
     if (Collision::AABB(playerCollider.collider, transition.collider)) {
       std::cout << "Trigger transition!" << std::endl;
-      std::string mapPath = transition.mapPath;
-
-      // Play transition sound (if there is one)
-      if (transition.sound)
-        Mix_PlayChannel(-1, transition.sound, 0);
-
-      unloadMap();
-      loadDemoMap(mapPath);
-
-      registry.getComponent<Sprite>(playerId).clean();
-      registry.destroy(playerId);
-      loadPlayer();
-
+      transitionMapPath = transition.mapPath;
+
+      // Play transition sound (if there is one). The transition is unloaded
+      // with its map straight after, so its sound is taken over until the
+      // next transition plays, rather than freed mid-play.
+      if (transition.sound) {
+        Mix_FreeChunk(transitionSound);
+        transitionSound = std::exchange(transition.sound, nullptr);
+        Mix_PlayChannel(-1, transitionSound, 0);
+      }
       break;
     }
   }
 
+  if (!transitionMapPath.empty()) {
+    // The player is kept and only moved to the new map's start position.
+    // The map being left is cached so coming back skips the map loader.
+    cacheMap();
+    unloadMap();
+    loadDemoMap(transitionMapPath);
+    placePlayer();
+
+    // Textures shared with the new map were picked up again while it
+    // loaded; the rest belonged only to the old one
+    TextureManager::EvictUnusedTextures();
+
+    // Pick up input on the new map next frame
+    updateCamera();
+    return;
+  }
+
   // Handle player movement via polling for smooth movement
   const bool* keyState = SDL_GetKeyboardState(nullptr);
   playerController.pollInput(keyState, playerTransform, playerSprite);
@@ -245,46 +255,41 @@ void DemoGame::onRender() {
   SDL_SetRenderDrawColor(renderer, 0, 0, 0, SDL_ALPHA_OPAQUE);
   SDL_RenderClear(renderer);
 
+  // The map and sprites are queued and submitted a texture at a time
+  TextureManager::BeginBatch();
+
   // Draw map
-  std::vector<EntityId> mapEntities = registry.getEntitiesWithComponents<Map>();
-  for (auto mapEntity : mapEntities) {
-    auto& map = registry.getComponent<Map>(mapEntity);
-    map.render();
-  }
+  registry.view<Map>().each([](EntityId, Map& map) { map.render(); });
 
   // Build a vector of sprites, sorted by Y coordinate
-  std::vector<std::pair<float, EntityId>> entityDrawOrder = {};
-  auto spriteEntities = registry.getEntitiesWithComponents<Sprite, Transform>();
-  for (auto entity : spriteEntities) {
-    auto& transform = registry.getComponent<Transform>(entity);
-
+  std::vector<std::pair<float, Sprite*>> entityDrawOrder = {};
+  auto spriteEntities = registry.view<Sprite, Transform>();
+  entityDrawOrder.reserve(spriteEntities.sizeHint());
+  for (auto [entity, sprite, transform] : spriteEntities) {
     entityDrawOrder.push_back({
       transform.position.y + transform.height,
-      entity
+      &sprite
     });
-
-    // Sort vector by Y coordinate
-    std::sort(
-      entityDrawOrder.begin(), entityDrawOrder.end(),
-      [](const auto a, const auto b) {
-        return a.first < b.first;
-      }
-    );
   }
 
+  // Sort vector by Y coordinate
+  std::sort(
+    entityDrawOrder.begin(), entityDrawOrder.end(),
+    [](const auto a, const auto b) {
+      return a.first < b.first;
+    }
+  );
+
   // Render the sprites based on draw order (topdown assumed)
   for (auto entityOrderEntry : entityDrawOrder) {
-    auto& sprite = registry.getComponent<Sprite>(entityOrderEntry.second);
-    sprite.render();
+    entityOrderEntry.second->render();
   }
+  TextureManager::EndBatch();
 
   // Render colliders -- this is only for debugging
   if (RENDER_COLLIDERS) {
-    auto colliderEntities = registry.getEntitiesWithComponents<Collider>();
-    for (auto entity : colliderEntities) {
-      auto& collider = registry.getComponent<Collider>(entity);
-      collider.render();
-    }
+    registry.view<Collider>().each(
+      [](EntityId, Collider& collider) { collider.render(); });
   }
 
   engine->uiManager->render(renderer, window);
@@ -295,14 +300,13 @@ void DemoGame::onRender() {
 void DemoGame::onCleanup() {
   auto& registry = engine->getRegistry();
 
+  // Sprite and map textures and transition sounds are released by the
+  // onRemove observers
   unloadMap();
-
-  // Clean player sprite -- other sprites are cleared by unloadMap()
-  Sprite* sprite = registry.tryGetComponent<Sprite>(playerId);
-  if (sprite)
-    sprite->clean();
-
   registry.clear();
+  Mix_FreeChunk(transitionSound);
+  transitionSound = nullptr;
+  TextureManager::SetAtlas(nullptr);
 
   SDL_Log("Demo game cleaned up!");
 }
@@ -348,6 +352,20 @@ void DemoGame::loadPlayer() {
   registry.addComponent<MouseController>(playerId);
 }
 
+void DemoGame::placePlayer() {
+  auto& registry = engine->getRegistry();
+
+  registry.patch<Transform>(playerId, [](Transform& transform) {
+    transform.position = Engine::mapData.startPos;
+    transform.startPosition = Engine::mapData.startPos;
+    transform.targetPosition = Engine::mapData.startPos;
+    transform.isMoving = false;
+    transform.moveProgress = 1.0f;
+  });
+  registry.getComponent<Collider>(playerId).update(
+    registry.getComponent<Transform>(playerId));
+}
+
 void DemoGame::loadDemoMap(const std::string& mapPath) {
   auto& registry = engine->getRegistry();
 
@@ -363,17 +381,36 @@ void DemoGame::loadDemoMap(const std::string& mapPath) {
     // mapPath from transition is already relative to assets
     mapToLoad = (assetsPath / mapPath).string();
   }
+  currentMap = mapToLoad;
+
+  // Maps visited before come back from their snapshot, as they were left
+  auto cached = visitedMaps.find(mapToLoad);
+  if (cached != visitedMaps.end()) {
+    Engine::mapData = cached->second.mapData;
+    mapAtlas.build(Engine::renderer, Engine::mapData.objectImages);
+    if (cached->second.snapshot.restore(registry, mapScope)) {
+      for (auto [entity, map] : registry.view<Map>())
+        mapId = entity;
+      return;
+    }
+    // A failed restore adds nothing, and a Map it had already loaded is
+    // cleaned (tileset released, chunks destroyed) before it returns
+    SDL_Log("Could not restore cached map %s, reloading it", mapToLoad.c_str());
+    visitedMaps.erase(cached);
+  }
 
   // Get map data
   MapLoader mapLoader = MapLoader(mapToLoad, TILE_SIZE);
   Engine::mapData = mapLoader.LoadMap();
+  mapAtlas.build(Engine::renderer, Engine::mapData.objectImages);
 
-  mapId = registry.create();
+  mapId = registry.create(mapScope);
   registry.addComponent<Map>(mapId, &Engine::mapData, Engine::mapData.tilesetImg.c_str(), TILE_SIZE);
 
   // Create entities from sprites first
+  registry.reserve<Sprite, Transform>(Engine::mapData.spriteVector.size());
   for (auto& spriteObject : Engine::mapData.spriteVector) {
-    EntityId spriteEntity = registry.create();
+    EntityId spriteEntity = registry.create(mapScope);
 
     MapObject& sprite = spriteObject.second;
     registry.addComponent<Sprite>(spriteEntity,
@@ -394,68 +431,69 @@ void DemoGame::loadDemoMap(const std::string& mapPath) {
     if (!mapEntities.contains(collider.objectId))
       continue;
 
-    // Get sprite entity -- it has the same ID as the collider
+    // Get sprite entity -- it has the same ID as the collider. The collider
+    // is a child of the sprite, so it follows the sprite if it moves.
     EntityId spriteEntity = mapEntities[collider.objectId];
-
-    // Fetch the corresponding Transform component
-    auto& transform = registry.getComponent<Transform>(spriteEntity);
-
-    // Calculate offsets here because the collider may move
-    Offset offset = {collider.xpos - transform.position.x,
-             collider.ypos - transform.position.y};
-    registry.addComponent<Collider>(spriteEntity, transform.position.x,
-                   transform.position.y, collider.width,
-                   collider.height, transform, offset);
+    EntityId colliderEntity = createChild(spriteEntity, collider);
+    auto& transform = registry.getComponent<Transform>(colliderEntity);
+    registry.addComponent<Collider>(colliderEntity, collider.xpos,
+                   collider.ypos, collider.width, collider.height, transform);
   }
 
-  // Process colliders, adding to existing sprite if they are linked
+  // Process colliders, adding to existing sprite if they are linked.
+  // Unlinked colliders are collected and spawned in one batch below.
+  std::vector<std::pair<int, MapObject*>> staticColliders = {};
   for (auto& colliderObject : Engine::mapData.colliderVector) {
-    EntityId colliderEntity = 0;
+    EntityId colliderEntity = nullEntity;
     MapObject& collider = colliderObject.second;
 
-    // Add the collider to linked (sprite) entity if it exists
+    // Attach the collider to the linked (sprite) entity if it exists
     // otherwise create a new entity
     if (collider.linkedId > 0 && mapEntities.contains(collider.linkedId)) {
-      colliderEntity = mapEntities[collider.linkedId];
-
-      // Fetch the corresponding Transform component
+      colliderEntity = createChild(mapEntities[collider.linkedId], collider);
       auto& transform = registry.getComponent<Transform>(colliderEntity);
-
-      // Calculate offsets here because the collider may move
-      Offset offset = {collider.xpos - transform.position.x,
-               collider.ypos - transform.position.y};
-      registry.addComponent<Collider>(colliderEntity, transform.position.x,
-                     transform.position.y, collider.width,
-                     collider.height, transform, offset);
+      registry.addComponent<Collider>(colliderEntity, collider.xpos,
+                     collider.ypos, collider.width, collider.height,
+                     transform);
     } else {
-      // Non-linked static collider, treat as its own entity
-      colliderEntity = registry.create();
-      registry.addComponent<Transform>(colliderEntity, collider.xpos, collider.ypos,
-                    collider.width, collider.height);
-
-      // Fetch a reference to the transform created above
-      auto& transform = registry.getComponent<Transform>(colliderEntity);
-
-      registry.addComponent<Collider>(colliderEntity, collider.xpos, collider.ypos,
-                     collider.width, collider.height, transform);
-
-      mapEntities[colliderObject.first] = colliderEntity;
+      staticColliders.push_back({colliderObject.first, &collider});
     }
   }
 
+  // Non-linked static colliders are entities of their own, differing only
+  // in position and size
+  Transform blockTransform(0, 0, TILE_SIZE, TILE_SIZE);
+  Prefab<Transform, Collider> staticCollider(
+    blockTransform, Collider(0, 0, TILE_SIZE, TILE_SIZE, blockTransform));
+  staticCollider.spawn(registry, staticColliders.size(),
+    [&](std::size_t index, EntityId entity, Transform& transform,
+        Collider& collider) {
+      MapObject& object = *staticColliders[index].second;
+      transform.position = Vector2D(object.xpos, object.ypos);
+      transform.startPosition = transform.position;
+      transform.width = object.width;
+      transform.height = object.height;
+      collider.collider.w = object.width;
+      collider.collider.h = object.height;
+      collider.update(transform);
+
+      mapEntities[staticColliders[index].first] = entity;
+    },
+    mapScope);
+
   // Process transitions
   for (auto& transitionObject : Engine::mapData.transitionVector) {
-    EntityId transitionEntity = registry.create();
+    EntityId transitionEntity = registry.create(mapScope);
     MapObject& transition = transitionObject.second;
 
     auto& transform = registry.addComponent<Transform>(
       transitionEntity, transition.xpos, transition.ypos, transition.width,
       transition.height);
 
-    Mix_Chunk* transitionSound = nullptr;
+    std::string transitionSound = "";
     auto transitionProperties = &transitionObject.second.properties;
     if (transitionProperties->contains("sound"))
-      transitionSound = Mix_LoadWAV(transitionProperties->at("sound").c_str());
+      transitionSound = transitionProperties->at("sound");
 
     registry.addComponent<Transition>(transitionEntity, transform,
                       transition.properties["file_path"],
@@ -466,22 +504,16 @@ void DemoGame::loadDemoMap(const std::string& mapPath) {
 
   // Process interaction objects and link to existing sprite
   for (auto& interactionObject : Engine::mapData.interactionVector) {
-    EntityId interactionEntity = 0;
+    EntityId interactionEntity = nullEntity;
     MapObject& interaction = interactionObject.second;
 
-    // Add the interaction to linked (sprite) entity if it exists
+    // Attach the interaction to the linked (sprite) entity if it exists
     if (interaction.linkedId > 0 && mapEntities.contains(interaction.linkedId)) {
-      interactionEntity = mapEntities[interaction.linkedId];
-
-      // Fetch the corresponding Transform component
-      auto& transform = registry.getComponent<Transform>(interactionEntity);
-
-      // Calculate offsets here because the interaction may move
-      Offset offset = {interaction.xpos - transform.position.x,
-               interaction.ypos - transform.position.y};
-      registry.addComponent<Interactable>(interactionEntity, transform.position.x,
-                        transform.position.y, interaction.width,
-                        interaction.height, offset);
+      interactionEntity = createChild(mapEntities[interaction.linkedId],
+                                      interaction);
+      registry.addComponent<Interactable>(interactionEntity, interaction.xpos,
+                        interaction.ypos, interaction.width,
+                        interaction.height);
 
       // Add dialogue file if there is one
       if (interaction.properties.contains("file_path"))
@@ -496,25 +528,78 @@ void DemoGame::loadDemoMap(const std::string& mapPath) {
   }
 }
 
-void DemoGame::unloadMap() {
+EntityId DemoGame::createChild(EntityId parent, const MapObject& object) {
+  auto& registry = engine->getRegistry();
+
+  EntityId child = registry.create(mapScope);
+  registry.addComponent<Transform>(child, object.xpos, object.ypos,
+                                   object.width, object.height);
+  TransformHierarchy::attach(registry, child, parent);
+  return child;
+}
+
+void DemoGame::cacheMap() {
+  auto& registry = engine->getRegistry();
+
+  if (currentMap.empty())
+    return;
+  CachedMap& cached = visitedMaps[currentMap];
+  cached.mapData = Engine::mapData;
+  cached.snapshot.save(registry, mapScope);
+}
+
+void DemoGame::quickSave() {
   auto& registry = engine->getRegistry();
 
-  // Clear all map entities
-  for (auto& entityEntry : mapEntities) {
-    EntityId entityId = entityEntry.second;
+  savedGame.mapPath = currentMap;
+  savedGame.mapData = Engine::mapData;
+  savedGame.snapshot.save(registry);
+  SDL_Log("Quick-saved (%zu bytes)", savedGame.snapshot.bytes().size());
+}
 
-    // Clear sprite textures
-    Sprite* sprite = registry.tryGetComponent<Sprite>(entityId);
-    if (sprite)
-      sprite->clean();
+void DemoGame::quickLoad() {
+  auto& registry = engine->getRegistry();
 
-    registry.destroy(entityId);
+  if (savedGame.snapshot.empty())
+    return;
+
+  // The saved map's sprites need its atlas. Build it alongside the current
+  // one, which stays in use if the restore fails.
+  TextureAtlas savedAtlas;
+  savedAtlas.build(Engine::renderer, savedGame.mapData.objectImages);
+
+  // The whole save is read before the registry is touched, so a bad one
+  // leaves the current game running as it was. Otherwise entities come back
+  // under their saved handles: the player was created once at start up and
+  // keeps its handle, but the map entity may be another map's by now.
+  MapData currentMapData = Engine::mapData;
+  Engine::mapData = savedGame.mapData;
+  TextureManager::SetAtlas(&savedAtlas);
+  bool restored = savedGame.snapshot.restore(registry);
+  TextureManager::SetAtlas(&mapAtlas);
+  if (!restored) {
+    Engine::mapData = currentMapData;
+    SDL_Log("Could not restore quick-save");
+    return;
   }
+  for (auto [entity, map] : registry.view<Map>())
+    mapId = entity;
+  mapAtlas = std::move(savedAtlas);
+  TextureManager::EvictUnusedTextures();
+  currentMap = savedGame.mapPath;
   mapEntities.clear();
+  transitionVersion = registry.changeVersion();
+  updateCamera();
+}
 
-  // Clean and destroy the map itself
-  Map* map = registry.tryGetComponent<Map>(mapId);
-  if (map)
-    map->clean();
-  registry.destroy(mapId);
+void DemoGame::unloadMap() {
+  auto& registry = engine->getRegistry();
+
+  // Everything the map created lives in its scope, so it all goes in one
+  // batch. Textures are released by the onRemove observers.
+  if (mapScope != globalScope)
+    registry.clearScope(mapScope);
+  mapAtlas.clear();
+  mapEntities.clear();
+  mapId = nullEntity;
 }
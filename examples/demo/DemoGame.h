@@ -2,7 +2,13 @@
 
 #include "IGame.h"
 #include "Components/ECS.h"
+#include "Components/Components.h"
+#include "Components/Hierarchy.h"
+#include "Components/Snapshot.h"
+#include "MapLoader.h"
 #include "SDL3/SDL_events.h"
+#include "SDL3_mixer/SDL_mixer.h"
+#include "TextureAtlas.h"
 
 // Forward declaration to avoid circular dependency
 class Engine;
@@ -25,12 +31,51 @@ private:
   EntityId playerId;
   EntityId mapId;
 
+  // Everything loaded with the current map. The player lives in the global
+  // scope, so it survives map switches.
+  ScopeId mapScope = globalScope;
+
+  // Last change version processed when syncing transitions
+  std::uint64_t transitionVersion = 0;
+
+  // Sound of the last transition taken, kept playing after its map is gone
+  Mix_Chunk *transitionSound = nullptr;
+
   std::unordered_map<int, EntityId> mapEntities;
 
+  // Object tileset images of the current map, packed so its sprites share
+  // textures. Rebuilt whenever the map changes.
+  TextureAtlas mapAtlas;
+
+  // Everything a snapshot needs to bring back the demo's entities
+  using DemoSnapshot = Snapshot<Transform, LocalTransform, Sprite, Collider,
+                                Transition, Interactable, Dialogue, Map,
+                                KeyboardController, MouseController>;
+
+  // Maps visited before, keyed by path, as they were when the player left
+  struct CachedMap {
+    MapData mapData;
+    DemoSnapshot snapshot;
+  };
+  std::unordered_map<std::string, CachedMap> visitedMaps;
+  std::string currentMap;
+
+  struct SavedGame {
+    std::string mapPath;
+    MapData mapData;
+    DemoSnapshot snapshot;
+  };
+  SavedGame savedGame;
+
   void loadPlayer();
+  void placePlayer();
   void loadDemoMap(const std::string& mapPath = "");
   void updateCamera();
   void unloadMap();
+  void cacheMap();
+  EntityId createChild(EntityId parent, const MapObject& object);
+  void quickSave();
+  void quickLoad();
 
   template <typename T>
   void clearEntities(std::unordered_map<int, T> entityVector);
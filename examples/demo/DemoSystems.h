@@ -0,0 +1,150 @@
+#pragma once
+
+#include "Pangolengine.h"
+#include <iostream>
+
+/*
+ * Advance moving transforms, carry children (attached colliders, interaction
+ * areas...) along with their parents, keep colliders in sync with the
+ * transforms that changed and stop the player walking into a collider.
+ */
+class MovementSystem : public System {
+public:
+  MovementSystem(EntityRegistry &registry, const EntityId &playerId)
+      : System("Movement"), playerId(playerId), hierarchy(registry) {
+    reads<LocalTransform>();
+    writes<Transform, Collider>();
+
+    // Create the group now, since creating it while other systems are
+    // iterating the registry isn't safe
+    registry.group<Collider, Transform>();
+  }
+
+  void update(EntityRegistry &registry) override {
+    // Colliders are iterated several times per frame, so keep them in a
+    // persistent group rather than filtering a view each time
+    auto colliderEntities = registry.group<Collider, Transform>();
+
+    // markChanged isn't thread safe, so record the moving entities up front
+    for (auto [entity, collider, transform] : colliderEntities) {
+      if (transform.isMoving)
+        registry.markChanged<Transform>(entity);
+    }
+
+    // Each entity only touches its own components, so moves can be stepped
+    // in parallel
+    colliderEntities.parallelEach(
+      [](EntityId, Collider& collider, Transform& transform) {
+        if (transform.isMoving) {
+          transform.update();
+          collider.update(transform);
+        }
+      });
+
+    // Children follow their parents in one pass, then colliders catch up
+    // with every transform that changed (here or elsewhere) since the last
+    // run. Most colliders belong to static props and are left alone.
+    hierarchy.propagate(registry);
+    registry.eachChanged<Transform>(lastVersion,
+      [&](EntityId entity, Transform& transform) {
+        if (Collider* collider = registry.tryGetComponent<Collider>(entity))
+          collider->update(transform);
+      });
+    lastVersion = registry.changeVersion();
+
+    if (!registry.valid(playerId))
+      return;
+
+    // Check for collision with player (if moving) and abort move on collision
+    auto& playerTransform = registry.getComponent<Transform>(playerId);
+    auto& playerCollider = registry.getComponent<Collider>(playerId);
+    if (!playerTransform.isMoving)
+      return;
+
+    // Make a collider where the player will be at the end of the move
+    SDL_FRect futureCollider;
+    futureCollider.x = playerTransform.targetPosition.x + playerCollider.offset.x;
+    futureCollider.y = playerTransform.targetPosition.y + playerCollider.offset.y;
+    futureCollider.h = playerCollider.collider.h;
+    futureCollider.w = playerCollider.collider.w;
+
+    for (auto [entity, collider, transform] : colliderEntities) {
+      if (entity == playerId)
+        continue;
+
+      if (Collision::AABB(futureCollider, collider.collider)) {
+        std::cout << "Player collision!" << std::endl;
+        playerTransform.abortMove();
+        playerCollider.update(playerTransform);
+        registry.markChanged<Transform>(playerId);
+        break;
+      }
+    }
+    lastVersion = registry.changeVersion();
+  }
+
+private:
+  const EntityId &playerId;
+  TransformHierarchy hierarchy;
+  std::uint64_t lastVersion = 0;
+};
+
+/*
+ * Flag the interactable objects the player is close enough to use. This only
+ * needs redoing when the player or an interactable has moved.
+ */
+class InteractionSystem : public System {
+public:
+  explicit InteractionSystem(const EntityId &playerId)
+      : System("Interaction"), playerId(playerId) {
+    reads<Collider, Transform>();
+    writes<Interactable>();
+  }
+
+  void update(EntityRegistry &registry) override {
+    if (!registry.valid(playerId))
+      return;
+
+    bool moved = false;
+    registry.eachChanged<Transform>(lastVersion,
+      [&](EntityId entity, Transform& transform) {
+        moved = true;
+        if (Interactable* interact = registry.tryGetComponent<Interactable>(entity))
+          interact->update(transform);
+      });
+    lastVersion = registry.changeVersion();
+
+    if (!moved)
+      return;
+
+    auto& playerCollider = registry.getComponent<Collider>(playerId);
+    registry.view<Interactable>().each(
+      [&](EntityId entity, Interactable& interact) {
+        interact.canInteract =
+          entity != playerId &&
+          Collision::AABB(playerCollider.collider, interact.interactArea);
+      });
+  }
+
+private:
+  const EntityId &playerId;
+  std::uint64_t lastVersion = 0;
+};
+
+/*
+ * Step sprite animations
+ */
+class AnimationSystem : public System {
+public:
+  AnimationSystem() : System("Animation") {
+    reads<Transform>();
+    writes<Sprite>();
+  }
+
+  void update(EntityRegistry &registry) override {
+    registry.view<Sprite, Transform>().each(
+      [](EntityId, Sprite& sprite, Transform& transform) {
+        sprite.update(transform);
+      });
+  }
+};
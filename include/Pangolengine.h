@@ -12,8 +12,15 @@
 // ECS (Entity Component System)
 //==============================================================================
 #include "Components/ECS.h"
+#include "Components/CommandBuffer.h"
+#include "Components/Prefab.h"
+#include "Components/Snapshot.h"
+#include "Components/Hierarchy.h"
+#include "Components/StaticRegistry.h"
 #include "Components/Components.h"
 #include "Components/KeyboardController.h"
+#include "Systems/System.h"
+#include "Systems/Scheduler.h"
 
 //==============================================================================
 // Core Systems
@@ -21,6 +28,9 @@
 #include "Camera.h"
 #include "MapLoader.h"
 #include "TextureManager.h"
+#include "TextureAtlas.h"
+#include "TextureCache.h"
+#include "TextRenderer.h"
 #include "Collision.h"
 
 //==============================================================================
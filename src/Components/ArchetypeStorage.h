@@ -0,0 +1,661 @@
+#pragma once
+
+#include "Entity.h"
+#include "SparseSetStorage.h"
+#include "../Systems/ThreadPool.h"
+#include <algorithm>
+#include <array>
+#include <cassert>
+#include <cstddef>
+#include <limits>
+#include <memory>
+#include <new>
+#include <tuple>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+//------------------------------------------------------------------------------
+// Component type information
+//------------------------------------------------------------------------------
+
+/*
+ * Type-erased operations needed to move components between archetypes
+ */
+struct ComponentTypeInfo {
+  std::size_t size = 0;
+  std::size_t alignment = 0;
+  void (*moveConstruct)(void *dst, void *src) = nullptr;
+  void (*destroy)(void *ptr) = nullptr;
+};
+
+template<typename T>
+ComponentTypeInfo makeComponentTypeInfo() {
+  return {
+    sizeof(T),
+    alignof(T),
+    [](void *dst, void *src) { new (dst) T(std::move(*static_cast<T*>(src))); },
+    [](void *ptr) { static_cast<T*>(ptr)->~T(); }
+  };
+}
+
+//------------------------------------------------------------------------------
+// Archetypes
+//------------------------------------------------------------------------------
+
+/*
+ * Where an entity's components live within archetype storage
+ */
+struct ArchetypeLocation {
+  static constexpr std::uint32_t none = std::numeric_limits<std::uint32_t>::max();
+
+  std::uint32_t archetype = none;
+  std::uint32_t chunk = 0;
+  std::uint32_t row = 0;
+};
+
+/*
+ * All entities that share one component signature. Entities are stored in
+ * fixed-size chunks, and each chunk holds a column of entity IDs followed by
+ * one column per component type, so iterating a component walks contiguous
+ * memory. Every chunk except the last one is full.
+ */
+class Archetype {
+public:
+  static constexpr std::size_t chunkBytes = 16 * 1024;
+  static constexpr std::size_t chunkAlignment = 64;
+  static constexpr std::int16_t noColumn = -1;
+
+  // Neighbouring archetypes (by index) reached by adding or removing a
+  // component, filled in as transitions are first used
+  std::array<std::uint32_t, maxComponents> addEdges;
+  std::array<std::uint32_t, maxComponents> removeEdges;
+
+  Archetype(const Signature &signature,
+            const std::vector<ComponentTypeInfo> &typeInfos)
+      : signature(signature) {
+    addEdges.fill(ArchetypeLocation::none);
+    removeEdges.fill(ArchetypeLocation::none);
+    columnOf.fill(noColumn);
+
+    std::size_t rowBytes = sizeof(EntityId);
+    for (std::size_t cid = 0; cid < maxComponents; cid++) {
+      if (!signature[cid])
+        continue;
+      assert(typeInfos[cid].alignment <= chunkAlignment &&
+             "Component alignment too large for archetype chunks!");
+      columnOf[cid] = static_cast<std::int16_t>(columns.size());
+      columns.push_back({static_cast<ComponentId>(cid), typeInfos[cid], 0});
+      rowBytes += typeInfos[cid].size;
+    }
+    capacity = std::max<std::size_t>(1, chunkBytes / rowBytes);
+
+    // Lay the columns out back to back, each aligned for its type
+    std::size_t offset = capacity * sizeof(EntityId);
+    for (auto &column : columns) {
+      offset = (offset + column.info.alignment - 1) /
+               column.info.alignment * column.info.alignment;
+      column.offset = offset;
+      offset += capacity * column.info.size;
+    }
+    chunkSize = offset;
+  }
+
+  Archetype(const Archetype &) = delete;
+  Archetype& operator=(const Archetype &) = delete;
+
+  ~Archetype() { clear(); }
+
+  const Signature& getSignature() const { return signature; }
+  std::size_t size() const { return count; }
+  std::size_t chunkCount() const { return chunks.size(); }
+
+  // Number of occupied rows in a chunk
+  std::size_t rowsIn(std::size_t chunk) const {
+    return std::min(capacity, count - chunk * capacity);
+  }
+
+  std::int16_t column(ComponentId cid) const { return columnOf[cid]; }
+
+  // Component types stored in this archetype, in column order
+  ComponentId columnComponent(std::size_t column) const {
+    return columns[column].cid;
+  }
+  std::size_t columnCount() const { return columns.size(); }
+
+  EntityId* entities(std::size_t chunk) {
+    return reinterpret_cast<EntityId*>(chunks[chunk].get());
+  }
+
+  template<typename T>
+  T* columnData(std::size_t chunk, std::int16_t column) {
+    return reinterpret_cast<T*>(chunks[chunk].get() + columns[column].offset);
+  }
+
+  void* componentAt(std::size_t chunk, std::size_t row, std::int16_t column) {
+    const Column &col = columns[column];
+    return chunks[chunk].get() + col.offset + row * col.info.size;
+  }
+
+  /*
+   * Append a row for the entity and return its location. The component slots
+   * in the row are left uninitialised for the caller to construct.
+   */
+  ArchetypeLocation pushRow(EntityId entityId, std::uint32_t archetypeIndex) {
+    if (count == chunks.size() * capacity)
+      chunks.push_back(allocateChunk());
+
+    ArchetypeLocation location = {
+      archetypeIndex,
+      static_cast<std::uint32_t>(count / capacity),
+      static_cast<std::uint32_t>(count % capacity)
+    };
+    entities(location.chunk)[location.row] = entityId;
+    ++count;
+    return location;
+  }
+
+  /*
+   * Destroy the components in a row and move the last row into its place.
+   * Returns the entity that was moved, or nullEntity if nothing moved.
+   */
+  EntityId eraseRow(std::size_t chunk, std::size_t row) {
+    std::size_t lastChunk = (count - 1) / capacity;
+    std::size_t lastRow = (count - 1) % capacity;
+
+    for (std::size_t c = 0; c < columns.size(); c++)
+      columns[c].info.destroy(componentAt(chunk, row, std::int16_t(c)));
+
+    EntityId movedEntity = nullEntity;
+    if (chunk != lastChunk || row != lastRow) {
+      for (std::size_t c = 0; c < columns.size(); c++) {
+        void *last = componentAt(lastChunk, lastRow, std::int16_t(c));
+        columns[c].info.moveConstruct(componentAt(chunk, row, std::int16_t(c)),
+                                      last);
+        columns[c].info.destroy(last);
+      }
+      movedEntity = entities(lastChunk)[lastRow];
+      entities(chunk)[row] = movedEntity;
+    }
+
+    // Free the last chunk as soon as it is empty
+    --count;
+    if (count == lastChunk * capacity)
+      chunks.pop_back();
+
+    return movedEntity;
+  }
+
+  /*
+   * Destroy every component and free all chunks
+   */
+  void clear() {
+    for (std::size_t chunk = 0; chunk < chunks.size(); chunk++) {
+      for (std::size_t row = 0; row < rowsIn(chunk); row++) {
+        for (std::size_t c = 0; c < columns.size(); c++)
+          columns[c].info.destroy(componentAt(chunk, row, std::int16_t(c)));
+      }
+    }
+    chunks.clear();
+    count = 0;
+  }
+
+private:
+  struct Column {
+    ComponentId cid;
+    ComponentTypeInfo info;
+    std::size_t offset;
+  };
+
+  struct ChunkDeleter {
+    void operator()(std::byte *data) const {
+      ::operator delete(data, std::align_val_t(chunkAlignment));
+    }
+  };
+  using ChunkPtr = std::unique_ptr<std::byte[], ChunkDeleter>;
+
+  Signature signature;
+  std::array<std::int16_t, maxComponents> columnOf;
+  std::vector<Column> columns = {};
+
+  std::size_t capacity = 0;  // rows per chunk
+  std::size_t chunkSize = 0; // bytes per chunk
+  std::size_t count = 0;     // rows across all chunks
+  std::vector<ChunkPtr> chunks = {};
+
+  ChunkPtr allocateChunk() const {
+    return ChunkPtr(static_cast<std::byte*>(
+        ::operator new(chunkSize, std::align_val_t(chunkAlignment))));
+  }
+};
+
+//------------------------------------------------------------------------------
+// Views
+//------------------------------------------------------------------------------
+
+/*
+ * Non-owning view over every archetype whose signature contains all of Ts.
+ * Iteration walks each matching archetype chunk by chunk and yields
+ * (entity, Ts&...) tuples; each() hands the callback pointers straight into the
+ * chunk columns and is the fastest way to visit many entities.
+ *
+ * Adding or removing components while iterating moves entities between
+ * archetypes and may skip or revisit entities.
+ */
+template<typename... Ts>
+class ArchetypeView {
+public:
+  using value_type = std::tuple<EntityId, Ts&...>;
+  using ArchetypeList = std::vector<std::unique_ptr<Archetype>>;
+
+  class Iterator {
+  public:
+    Iterator(const ArchetypeView *view, std::size_t archetype)
+        : view(view), archetype(archetype) {
+      skipEmpty();
+    }
+
+    value_type operator*() const {
+      Archetype &current = *(*view->archetypes)[archetype];
+      return value_type(
+          current.entities(chunk)[row],
+          current.template columnData<Ts>(
+              chunk, current.column(getComponentId<Ts>()))[row]...);
+    }
+
+    Iterator& operator++() {
+      ++row;
+      skipEmpty();
+      return *this;
+    }
+
+    bool operator==(const Iterator &other) const {
+      return archetype == other.archetype && chunk == other.chunk &&
+             row == other.row;
+    }
+
+  private:
+    const ArchetypeView *view;
+    std::size_t archetype;
+    std::size_t chunk = 0;
+    std::size_t row = 0;
+
+    // Advance to the next occupied row of a matching archetype
+    void skipEmpty() {
+      const ArchetypeList &archetypes = *view->archetypes;
+      while (archetype < archetypes.size()) {
+        Archetype &current = *archetypes[archetype];
+        if (view->matches(current) && chunk < current.chunkCount()) {
+          if (row < current.rowsIn(chunk))
+            return;
+          ++chunk;
+          row = 0;
+        } else {
+          ++archetype;
+          chunk = 0;
+          row = 0;
+        }
+      }
+    }
+  };
+
+  ArchetypeView(ArchetypeList *archetypes, Signature mask)
+      : archetypes(archetypes), mask(mask) {}
+
+  Iterator begin() const { return Iterator(this, 0); }
+  Iterator end() const { return Iterator(this, archetypes->size()); }
+
+  /*
+   * Call func(entity, Ts&...) for every matching entity
+   */
+  template<typename Func>
+  void each(Func func) const {
+    for (auto &archetype : *archetypes) {
+      if (!matches(*archetype))
+        continue;
+
+      for (std::size_t chunk = 0; chunk < archetype->chunkCount(); chunk++) {
+        EntityId *entities = archetype->entities(chunk);
+        std::size_t rows = archetype->rowsIn(chunk);
+        auto columns = std::make_tuple(archetype->template columnData<Ts>(
+            chunk, archetype->column(getComponentId<Ts>()))...);
+
+        std::apply([&](Ts*... column) {
+          for (std::size_t row = 0; row < rows; row++)
+            func(entities[row], column[row]...);
+        }, columns);
+      }
+    }
+  }
+
+  /*
+   * Like each(), but runs the matching archetype chunks in parallel on the
+   * shared thread pool. The result is deterministic as long as func only
+   * writes to the components it is given; func must not add or remove
+   * components or entities.
+   */
+  template<typename Func>
+  void parallelEach(Func func) const {
+    parallelEach(ThreadPool::shared(), func);
+  }
+
+  template<typename Func>
+  void parallelEach(ThreadPool &pool, Func func) const {
+    // Archetype chunks are cache line aligned and hold a few hundred rows,
+    // so each one is a task
+    std::vector<std::pair<Archetype*, std::size_t>> work;
+    for (auto &archetype : *archetypes) {
+      if (!matches(*archetype))
+        continue;
+      for (std::size_t chunk = 0; chunk < archetype->chunkCount(); chunk++)
+        work.emplace_back(archetype.get(), chunk);
+    }
+
+    pool.parallelFor(work.size(), 1, [&](std::size_t begin, std::size_t end) {
+      for (std::size_t item = begin; item < end; item++) {
+        auto [archetype, chunk] = work[item];
+        EntityId *entities = archetype->entities(chunk);
+        std::size_t rows = archetype->rowsIn(chunk);
+        auto columns = std::make_tuple(archetype->template columnData<Ts>(
+            chunk, archetype->column(getComponentId<Ts>()))...);
+
+        std::apply([&](Ts*... column) {
+          for (std::size_t row = 0; row < rows; row++)
+            func(entities[row], column[row]...);
+        }, columns);
+      }
+    });
+  }
+
+  // Number of entities the view yields
+  std::size_t sizeHint() const {
+    std::size_t total = 0;
+    for (auto &archetype : *archetypes) {
+      if (matches(*archetype))
+        total += archetype->size();
+    }
+    return total;
+  }
+
+private:
+  ArchetypeList *archetypes;
+  Signature mask;
+
+  bool matches(const Archetype &archetype) const {
+    return (archetype.getSignature() & mask) == mask;
+  }
+};
+
+/*
+ * View over an explicit list of entities (such as a group) that are known to
+ * have every component in Ts. Components are looked up one entity at a time.
+ */
+template<typename Storage, typename... Ts>
+class EntityListView {
+public:
+  using value_type = std::tuple<EntityId, Ts&...>;
+
+  class Iterator {
+  public:
+    Iterator(const EntityListView *view, std::size_t index)
+        : view(view), index(index) {}
+
+    value_type operator*() const {
+      EntityId entityId = (*view->candidates)[index];
+      return value_type(entityId,
+                        view->storage->template get<Ts>(entityId)...);
+    }
+
+    Iterator& operator++() {
+      ++index;
+      return *this;
+    }
+
+    bool operator==(const Iterator &other) const {
+      return index == other.index;
+    }
+
+  private:
+    const EntityListView *view;
+    std::size_t index;
+  };
+
+  EntityListView(const std::vector<EntityId> *candidates, Storage *storage)
+      : candidates(candidates), storage(storage) {}
+
+  Iterator begin() const { return Iterator(this, 0); }
+  Iterator end() const { return Iterator(this, candidates->size()); }
+
+  template<typename Func>
+  void each(Func func) const {
+    for (EntityId entityId : *candidates)
+      func(entityId, storage->template get<Ts>(entityId)...);
+  }
+
+  /*
+   * Like each(), but splits the entities into chunks run in parallel on the
+   * shared thread pool. The result is deterministic as long as func only
+   * writes to the components it is given; func must not add or remove
+   * components or entities.
+   */
+  template<typename Func>
+  void parallelEach(Func func) const {
+    parallelEach(ThreadPool::shared(), func);
+  }
+
+  template<typename Func>
+  void parallelEach(ThreadPool &pool, Func func) const {
+    std::size_t count = candidates->size();
+    pool.parallelFor(count, pool.chunkSizeFor<EntityId>(count),
+      [&](std::size_t begin, std::size_t end) {
+        for (std::size_t index = begin; index < end; index++) {
+          EntityId entityId = (*candidates)[index];
+          func(entityId, storage->template get<Ts>(entityId)...);
+        }
+      });
+  }
+
+  std::size_t sizeHint() const { return candidates->size(); }
+
+private:
+  const std::vector<EntityId> *candidates;
+  Storage *storage;
+};
+
+//------------------------------------------------------------------------------
+// Storage
+//------------------------------------------------------------------------------
+
+/*
+ * Component storage that groups entities by signature into archetypes. Adding
+ * or removing a component moves the entity's row to the archetype for its new
+ * signature, so structural changes cost more than with sparse sets, but
+ * iterating a component combination only walks matching chunks.
+ *
+ * Components move whenever their entity changes signature or another entity
+ * in the same archetype is removed, so references returned by add() and get()
+ * are only valid until the next structural change.
+ */
+class ArchetypeStorage {
+public:
+  template<typename T, typename... TArgs>
+  T& add(EntityId entityId, TArgs&&... mArgs) {
+    ComponentId cid = getComponentId<T>();
+    assert(cid < maxComponents && "Too many component types!");
+    if (typeInfos[cid].size == 0)
+      typeInfos[cid] = makeComponentTypeInfo<T>();
+
+    // Construct the component before moving the entity, so arguments that
+    // refer to the entity's other components are still valid
+    T component(std::forward<TArgs>(mArgs)...);
+
+    std::uint32_t index = entityIndex(entityId);
+    if (index >= locations.size())
+      locations.resize(index + 1);
+
+    std::uint32_t source = locations[index].archetype;
+    std::uint32_t target = (source == ArchetypeLocation::none)
+                               ? assureArchetype(Signature().set(cid))
+                               : addEdge(source, cid);
+    moveEntity(entityId, target);
+
+    const ArchetypeLocation &location = locations[index];
+    Archetype &archetype = *archetypes[target];
+    void *slot = archetype.componentAt(location.chunk, location.row,
+                                       archetype.column(cid));
+    return *new (slot) T(std::move(component));
+  }
+
+  template<typename T>
+  void remove(EntityId entityId) {
+    ComponentId cid = getComponentId<T>();
+    std::uint32_t index = entityIndex(entityId);
+    std::uint32_t source = locations[index].archetype;
+
+    // Entities without any components aren't stored at all
+    if (archetypes[source]->getSignature().count() == 1) {
+      eraseEntity(entityId);
+      return;
+    }
+
+    moveEntity(entityId, removeEdge(source, cid));
+  }
+
+  template<typename T>
+  T& get(EntityId entityId) {
+    const ArchetypeLocation &location = locations[entityIndex(entityId)];
+    Archetype &archetype = *archetypes[location.archetype];
+    return *static_cast<T*>(archetype.componentAt(
+        location.chunk, location.row, archetype.column(getComponentId<T>())));
+  }
+
+  void destroy(EntityId entityId, const Signature &signature) {
+    if (signature.any())
+      eraseEntity(entityId);
+  }
+
+  /*
+   * Remove all components of the entities in batch. Each entity costs one
+   * row erase, however many component types it has.
+   */
+  void destroyAll(const SparseSet &batch, const Signature &) {
+    for (EntityId entityId : batch.entities())
+      eraseEntity(entityId);
+  }
+
+  void clear() {
+    archetypes.clear();
+    archetypeIndex.clear();
+    locations.clear();
+  }
+
+  /*
+   * Chunks are allocated 16KB at a time as rows are added, and an empty
+   * trailing chunk is freed straight away, so there is nothing to reserve
+   */
+  template<typename T>
+  void reserve(std::size_t) {}
+
+  /*
+   * View over all archetypes containing every component in Ts
+   */
+  template<typename... Ts>
+  ArchetypeView<Ts...> view(const std::vector<Entity> &) {
+    return ArchetypeView<Ts...>(&archetypes, makeSignature<Ts...>());
+  }
+
+  /*
+   * View over a list of entities that are known to have every component in Ts
+   */
+  template<typename... Ts>
+  EntityListView<ArchetypeStorage, Ts...> view(
+      const std::vector<EntityId> &candidates,
+      const std::vector<Entity> &) {
+    return EntityListView<ArchetypeStorage, Ts...>(&candidates, this);
+  }
+
+private:
+  std::vector<ComponentTypeInfo> typeInfos =
+      std::vector<ComponentTypeInfo>(maxComponents);
+  std::vector<std::unique_ptr<Archetype>> archetypes = {};
+  std::unordered_map<Signature, std::uint32_t> archetypeIndex = {};
+
+  // Indexed by entity slot
+  std::vector<ArchetypeLocation> locations = {};
+
+  /*
+   * Return the index of the archetype for a signature, creating it if needed
+   */
+  std::uint32_t assureArchetype(const Signature &signature) {
+    auto it = archetypeIndex.find(signature);
+    if (it != archetypeIndex.end())
+      return it->second;
+
+    std::uint32_t index = static_cast<std::uint32_t>(archetypes.size());
+    archetypes.push_back(std::make_unique<Archetype>(signature, typeInfos));
+    archetypeIndex[signature] = index;
+    return index;
+  }
+
+  std::uint32_t addEdge(std::uint32_t source, ComponentId cid) {
+    std::uint32_t &edge = archetypes[source]->addEdges[cid];
+    if (edge == ArchetypeLocation::none)
+      edge = assureArchetype(Signature(archetypes[source]->getSignature()).set(cid));
+    return edge;
+  }
+
+  std::uint32_t removeEdge(std::uint32_t source, ComponentId cid) {
+    std::uint32_t &edge = archetypes[source]->removeEdges[cid];
+    if (edge == ArchetypeLocation::none)
+      edge = assureArchetype(Signature(archetypes[source]->getSignature()).reset(cid));
+    return edge;
+  }
+
+  /*
+   * Move the entity's row into the target archetype. Components the target
+   * shares with the source are moved across; a component only in the target
+   * is left for the caller to construct, and one only in the source is
+   * destroyed.
+   */
+  void moveEntity(EntityId entityId, std::uint32_t target) {
+    std::uint32_t index = entityIndex(entityId);
+    ArchetypeLocation source = locations[index];
+    Archetype &to = *archetypes[target];
+    ArchetypeLocation destination = to.pushRow(entityId, target);
+
+    if (source.archetype != ArchetypeLocation::none) {
+      Archetype &from = *archetypes[source.archetype];
+      for (std::size_t c = 0; c < from.columnCount(); c++) {
+        std::int16_t column = to.column(from.columnComponent(c));
+        if (column == Archetype::noColumn)
+          continue;
+        typeInfos[from.columnComponent(c)].moveConstruct(
+            to.componentAt(destination.chunk, destination.row, column),
+            from.componentAt(source.chunk, source.row, std::int16_t(c)));
+      }
+      eraseRow(source);
+    }
+
+    locations[index] = destination;
+  }
+
+  /*
+   * Destroy all of the entity's components and forget its location
+   */
+  void eraseEntity(EntityId entityId) {
+    std::uint32_t index = entityIndex(entityId);
+    if (index >= locations.size() ||
+        locations[index].archetype == ArchetypeLocation::none)
+      return;
+
+    eraseRow(locations[index]);
+    locations[index] = {};
+  }
+
+  void eraseRow(const ArchetypeLocation &location) {
+    EntityId movedEntity = archetypes[location.archetype]->eraseRow(
+        location.chunk, location.row);
+    if (movedEntity != nullEntity)
+      locations[entityIndex(movedEntity)] = location;
+  }
+};
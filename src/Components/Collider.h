@@ -18,29 +18,23 @@ public:
     collider.w = width;
     collider.h = height;
 
-    destRect.x = collider.x - Camera::position.x;
-    destRect.y = collider.y - Camera::position.y;
-    destRect.w = width;
-    destRect.h = height;
-
     this->offset = offset;
   }
 
   void update(Transform &transform) {
     collider.x = transform.position.x + offset.x;
     collider.y = transform.position.y + offset.y;
-
-    destRect.x = collider.x - Camera::position.x;
-    destRect.y = collider.y - Camera::position.y;
   }
 
   void render() {
+    // Position on screen is worked out here, so the collider only needs
+    // updating when its transform moves
+    SDL_FRect destRect = {collider.x - Camera::position.x,
+                          collider.y - Camera::position.y,
+                          collider.w, collider.h};
     SDL_SetRenderDrawColor(Engine::renderer, 0, 255, 0,
                            SDL_ALPHA_OPAQUE);
     SDL_RenderRect(Engine::renderer, &destRect);
     SDL_RenderFillRect(Engine::renderer, &destRect);
   }
-
-private:
-  SDL_FRect destRect;
 };
@@ -0,0 +1,162 @@
+#pragma once
+
+#include "ECS.h"
+#include <algorithm>
+#include <cassert>
+#include <cstdint>
+#include <memory>
+#include <utility>
+#include <vector>
+
+/*
+ * Records structural changes (create, destroy, add and remove component) so
+ * they can be applied to the registry later in one batch, e.g. once a view
+ * has finished iterating or at the end of a frame's systems. A buffer must
+ * only be used from one thread at a time; give each thread or system its own.
+ *
+ * create() returns a pending handle that is only meaningful to this buffer.
+ * Pass it to addComponent() or destroy() on the same buffer, and it will be
+ * swapped for the real entity when the buffer is flushed.
+ */
+class CommandBuffer {
+public:
+  /*
+   * Queue the creation of an entity and return its pending handle
+   */
+  EntityId create() {
+    assert(createCount < entityIndexMask && "Too many pending entities!");
+    return makeEntityId(++createCount, pendingGeneration);
+  }
+
+  /*
+   * Queue the destruction of an entity. Destroys are applied after every
+   * other command in the buffer.
+   */
+  void destroy(EntityId entityId) {
+    destroys.push_back(entityId);
+  }
+
+  /*
+   * Queue adding a component. The component is constructed now and moved
+   * into the registry on flush. If the entity already has one by then, it is
+   * replaced.
+   */
+  template<typename T, typename... TArgs>
+  void addComponent(EntityId entityId, TArgs&&... mArgs) {
+    componentCommands.push_back({
+      entityId, getComponentId<T>(),
+      std::make_unique<DeferredComponentOf<T>>(std::forward<TArgs>(mArgs)...),
+      nullptr
+    });
+  }
+
+  /*
+   * Queue removing a component. Does nothing on flush if the entity no longer
+   * has it.
+   */
+  template<typename T>
+  void removeComponent(EntityId entityId) {
+    componentCommands.push_back({
+      entityId, getComponentId<T>(), nullptr,
+      [](EntityRegistry &registry, EntityId target) {
+        if (registry.hasComponent<T>(target))
+          registry.removeComponent<T>(target);
+      }
+    });
+  }
+
+  bool empty() const {
+    return createCount == 0 && componentCommands.empty() && destroys.empty();
+  }
+
+  /*
+   * Apply all queued commands and clear the buffer. Entities are created
+   * first, then component commands are applied grouped by component type
+   * (keeping their order within a type), then entities are destroyed.
+   * Commands targeting entities that have been destroyed are skipped.
+   */
+  void flush(EntityRegistry &registry) {
+    created.clear();
+    created.reserve(createCount);
+    for (std::uint32_t i = 0; i < createCount; i++)
+      created.push_back(registry.create());
+
+    // Applying one component type at a time keeps each pool hot in cache
+    std::stable_sort(componentCommands.begin(), componentCommands.end(),
+                     [](const ComponentCommand &a, const ComponentCommand &b) {
+                       return a.cid < b.cid;
+                     });
+
+    for (auto &command : componentCommands) {
+      EntityId entityId = resolve(command.entityId);
+      if (!registry.valid(entityId))
+        continue;
+
+      if (command.component)
+        command.component->addTo(registry, entityId);
+      else
+        command.remove(registry, entityId);
+    }
+
+    for (EntityId entityId : destroys)
+      registry.destroy(resolve(entityId));
+
+    clear();
+  }
+
+  /*
+   * Discard all queued commands
+   */
+  void clear() {
+    createCount = 0;
+    componentCommands.clear();
+    destroys.clear();
+  }
+
+private:
+  // Generation 0 is never issued by the registry, so it marks pending handles
+  static constexpr std::uint32_t pendingGeneration = 0;
+
+  struct DeferredComponent {
+    virtual ~DeferredComponent() = default;
+    virtual void addTo(EntityRegistry &registry, EntityId entityId) = 0;
+  };
+
+  template<typename T>
+  struct DeferredComponentOf : DeferredComponent {
+    T component;
+
+    template<typename... TArgs>
+    explicit DeferredComponentOf(TArgs&&... mArgs)
+        : component(std::forward<TArgs>(mArgs)...) {}
+
+    void addTo(EntityRegistry &registry, EntityId entityId) override {
+      if (registry.hasComponent<T>(entityId))
+        registry.replaceComponent<T>(entityId, std::move(component));
+      else
+        registry.addComponent<T>(entityId, std::move(component));
+    }
+  };
+
+  struct ComponentCommand {
+    EntityId entityId;
+    ComponentId cid;
+    std::unique_ptr<DeferredComponent> component; // set for adds
+    void (*remove)(EntityRegistry &registry, EntityId entityId);
+  };
+
+  std::uint32_t createCount = 0;
+  std::vector<ComponentCommand> componentCommands = {};
+  std::vector<EntityId> destroys = {};
+  std::vector<EntityId> created = {};
+
+  EntityId resolve(EntityId entityId) const {
+    if (entityId != nullEntity &&
+        entityGeneration(entityId) == pendingGeneration) {
+      assert(entityIndex(entityId) <= created.size() &&
+             "Pending entity from another command buffer!");
+      return created[entityIndex(entityId) - 1];
+    }
+    return entityId;
+  }
+};
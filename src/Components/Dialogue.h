@@ -4,6 +4,8 @@
 #include <vector>
 #include <filesystem>
 #include "../Parsers/JsonParser.h"
+#include "Snapshot.h"
+#include "StoragePolicy.h"
 
 namespace fs = std::filesystem;
 
@@ -22,6 +24,9 @@ struct DialogueNode {
 
 class Dialogue {
 public:
+  // Only a few entities per map have one
+  static constexpr StoragePolicy storagePolicy = StoragePolicy::Sparse;
+
   std::vector<DialogueNode> dialogueTree = {};
   int currentNode = -1;
   bool active = false;
@@ -63,6 +68,50 @@ public:
 
   ~Dialogue() {}
 
+  /*
+   * Snapshot hooks. The parsed tree is saved as is, so restoring doesn't
+   * read the dialogue file again.
+   */
+  void saveSnapshot(SnapshotWriter &out) const {
+    out.write(static_cast<std::uint32_t>(dialogueTree.size()));
+    for (const DialogueNode &node : dialogueTree) {
+      out.write(node.id);
+      out.writeString(node.speaker);
+      out.writeString(node.portrait);
+      out.writeString(node.line);
+      out.write(static_cast<std::uint32_t>(node.responses.size()));
+      for (const Response &response : node.responses) {
+        out.writeString(response.line);
+        out.write(response.next);
+      }
+    }
+    out.write(currentNode);
+    out.write(static_cast<std::uint8_t>(active));
+    out.write(static_cast<std::uint8_t>(canRespond));
+  }
+
+  static Dialogue loadSnapshot(SnapshotReader &in) {
+    Dialogue dialogue;
+    std::uint32_t nodeCount = in.read<std::uint32_t>();
+    for (std::uint32_t i = 0; i < nodeCount && in.ok(); i++) {
+      DialogueNode node;
+      node.id = in.read<int>();
+      node.speaker = in.readString();
+      node.portrait = in.readString();
+      node.line = in.readString();
+      std::uint32_t responseCount = in.read<std::uint32_t>();
+      for (std::uint32_t j = 0; j < responseCount && in.ok(); j++) {
+        std::string line = in.readString();
+        node.responses.push_back({line, in.read<int>()});
+      }
+      dialogue.dialogueTree.push_back(std::move(node));
+    }
+    dialogue.currentNode = in.read<int>();
+    dialogue.active = in.read<std::uint8_t>() != 0;
+    dialogue.canRespond = in.read<std::uint8_t>() != 0;
+    return dialogue;
+  }
+
   void beginDialogue() {
     if (!dialogueTree.empty()) {
       currentNode = dialogueTree.front().id;
@@ -118,6 +167,8 @@ public:
   }
 
 private:
+  Dialogue() = default;
+
   DialogueNode *getNodeFromId(int id) {
     for (auto &node : dialogueTree) {
       if (node.id == id)
@@ -1,136 +1,273 @@
 #pragma once
 
-#include <bitset>
+#include "Entity.h"
+#include "SparseSetStorage.h"
+#ifdef PANGOLENGINE_ARCHETYPE_STORAGE
+#include "ArchetypeStorage.h"
+#endif
+#include <array>
+#include <atomic>
+#include <cassert>
 #include <cstdint>
+#include <functional>
+#include <limits>
 #include <memory>
 #include <unordered_map>
 #include <utility>
 #include <vector>
-#include <cassert>
-
-constexpr std::size_t maxComponents = 32;
 
 //------------------------------------------------------------------------------
-// Entity
+// Groups
 //------------------------------------------------------------------------------
-using EntityId = std::size_t;
-struct Entity {
-  std::bitset<maxComponents> componentBitset = 0;
-};
 
-//------------------------------------------------------------------------------
-// Components
-//------------------------------------------------------------------------------
+/*
+ * Persistent list of the entities whose signature contains a given mask. The
+ * registry keeps it up to date as components are added and removed, so
+ * iterating it never has to filter.
+ */
+class Group : public SparseSet {
+public:
+  explicit Group(Signature mask) : mask(mask) {}
 
-using ComponentId = std::uint8_t;
-class ComponentIdGenerator {
-private:
-    static inline ComponentId nextId = 0;
+  const Signature& signature() const { return mask; }
 
-public:
-    template<typename T>
-    static ComponentId getId() {
-        static ComponentId id = nextId++;
-        return id;
+  /*
+   * Add or remove the entity so membership matches its current signature
+   */
+  void refresh(EntityId entityId, const Signature &entitySignature) {
+    bool matches = (entitySignature & mask) == mask;
+    bool member = contains(entityId);
+    if (matches && !member)
+      insert(entityId);
+    else if (!matches && member)
+      swapAndPop(entityId);
+  }
+
+  /*
+   * Drop any entities in batch from the group
+   */
+  void removeEntities(const SparseSet &batch) {
+    for (EntityId entityId : batch.entities()) {
+      if (contains(entityId))
+        swapAndPop(entityId);
     }
+  }
+
+  void clear() { reset(); }
+
+private:
+  Signature mask;
 };
 
-template<typename T>
-ComponentId getComponentId() {
-    return ComponentIdGenerator::getId<T>();
-}
+//------------------------------------------------------------------------------
+// Scopes
+//------------------------------------------------------------------------------
 
-class IComponentArray {
+/*
+ * The entities created in one scope
+ */
+class ScopeMembers : public SparseSet {
 public:
-    virtual ~IComponentArray() = default;
-    virtual void removeComponent(EntityId entityId) = 0;
+  void add(EntityId entityId) { insert(entityId); }
+  void remove(EntityId entityId) { swapAndPop(entityId); }
+  void clear() { reset(); }
 };
 
-template<typename T>
-class ComponentArray : public IComponentArray {
+//------------------------------------------------------------------------------
+// Change tracking
+//------------------------------------------------------------------------------
+
+/*
+ * Entities whose component of one type has changed, each with the registry
+ * version at which it last changed. Consumers remember the version they last
+ * processed and only visit entries newer than that.
+ */
+class ChangeTracker : public SparseSet {
 public:
-  T& addComponent(EntityId entityId, T &component) {
-    std::size_t index = components.size();
-    components.push_back(std::move(component));
-    entityToIndex[entityId] = index;
-    indexToEntity[index] = entityId;
-    return components[entityToIndex[entityId]];
+  void mark(EntityId entityId, std::uint64_t version) {
+    std::size_t index = indexOf(entityId);
+    if (index != nullIndex) {
+      versions[index] = version;
+      return;
+    }
+    insert(entityId);
+    versions.push_back(version);
   }
 
-  T& getComponent(EntityId entityId) {
-      return components[entityToIndex[entityId]];
+  void erase(EntityId entityId) {
+    std::size_t index = indexOf(entityId);
+    if (index == nullIndex)
+      return;
+    versions[index] = versions.back();
+    versions.pop_back();
+    swapAndPop(entityId);
   }
 
-  void removeComponent(EntityId entityId) override {
-    if (!entityToIndex.contains(entityId)) {
-        return;
+  /*
+   * Forget changes made before the given version
+   */
+  void trim(std::uint64_t before) {
+    for (std::size_t index = size(); index-- > 0;) {
+      if (versions[index] < before)
+        erase(entities()[index]);
     }
+  }
 
-    std::size_t indexToRemove = entityToIndex[entityId];
-    std::size_t lastIndex = components.size() - 1;
+  std::uint64_t versionAt(std::size_t index) const { return versions[index]; }
 
-    if (indexToRemove != lastIndex) {
-      components[indexToRemove] = std::move(components[lastIndex]);
-      EntityId lastEntityId = indexToEntity[lastIndex];
-      entityToIndex[lastEntityId] = indexToRemove;
-      indexToEntity[indexToRemove] = lastEntityId;
-    }
-
-    components.pop_back();
-    entityToIndex.erase(entityId);
-    indexToEntity.erase(lastIndex);
+  void clear() {
+    reset();
+    versions.clear();
   }
 
 private:
-    std::vector<T> components = {};
-    std::unordered_map<EntityId, std::size_t> entityToIndex = {};
-    std::unordered_map<std::size_t, EntityId> indexToEntity = {};
+  std::vector<std::uint64_t> versions = {};
 };
 
+class EntityRegistry;
+
+// Called with the registry and the entity whose component was added, removed
+// or changed
+using ComponentObserver = std::function<void(EntityRegistry&, EntityId)>;
+
 //------------------------------------------------------------------------------
 // Registry
 //------------------------------------------------------------------------------
+
+/*
+ * The component storage backend is chosen at compile time. Sparse sets (the
+ * default) make adding and removing components cheap; archetypes keep
+ * entities with the same signature together in chunks, which makes iterating
+ * large numbers of entities cheaper. Enable PANGOLENGINE_ARCHETYPE_STORAGE in
+ * CMake to use archetypes.
+ */
+#ifdef PANGOLENGINE_ARCHETYPE_STORAGE
+using ComponentStorage = ArchetypeStorage;
+#else
+using ComponentStorage = SparseSetStorage;
+#endif
+
 class EntityRegistry {
 public:
+  EntityRegistry(const EntityRegistry &) = delete;
+  EntityRegistry& operator=(const EntityRegistry &) = delete;
+
   EntityRegistry() {};
 
   /*
-   * Add an entity to the manager and return its ID
+   * Add an entity to the manager and return its ID. Slots freed by destroyed
+   * entities are reused before the entity table grows. Entities created in a
+   * scope other than the global one are destroyed along with it by
+   * clearScope().
    */
-  EntityId create() {
-    EntityId entityId = ++entityIdCounter;
-    entityMap[entityId] = std::unique_ptr<Entity>(new Entity{});
+  EntityId create(ScopeId scope = globalScope) {
+    EntityId entityId = entities.create();
+    if (scope != globalScope) {
+      entities[entityIndex(entityId)].scope = scope;
+      scopeMembers(scope).add(entityId);
+    }
     return entityId;
   };
 
+  /*
+   * Create a scope for entities that share a lifetime, such as everything
+   * loaded with a map. Scopes are meant to be long-lived: clearScope()
+   * empties a scope so it can be filled again.
+   */
+  ScopeId createScope() {
+    assert(scopes.size() < std::numeric_limits<ScopeId>::max() &&
+           "Too many scopes!");
+    scopes.push_back(std::make_unique<ScopeMembers>());
+    return static_cast<ScopeId>(scopes.size());
+  }
+
+  ScopeId scopeOf(EntityId entityId) const {
+    assert(valid(entityId) && "Entity not found!");
+    return entities[entityIndex(entityId)].scope;
+  }
+
+  /*
+   * The entities currently in a scope, in no particular order
+   */
+  const std::vector<EntityId>& entitiesIn(ScopeId scope) {
+    return scopeMembers(scope).entities();
+  }
+
+  /*
+   * Destroy every entity in the scope in one go. Each component array the
+   * scope's entities use is visited once, instead of every array once per
+   * entity, and only component types with onRemove observers or change
+   * tracking are visited entity by entity. The scope can be reused.
+   */
+  void clearScope(ScopeId scope) {
+    assert(scope != globalScope && "Use clear() to destroy every entity!");
+    ScopeMembers &members = scopeMembers(scope);
+    if (members.empty())
+      return;
+
+    Signature used;
+    for (EntityId entityId : members.entities())
+      used |= entities[entityIndex(entityId)].componentBitset;
+
+    for (std::size_t cid = 0; cid < maxComponents; cid++) {
+      if (!used[cid] || (hooks[cid].onRemove.empty() && !changeTrackers[cid]))
+        continue;
+      for (EntityId entityId : members.entities()) {
+        if (!entities[entityIndex(entityId)].componentBitset[cid])
+          continue;
+        notify(hooks[cid].onRemove, entityId);
+        if (changeTrackers[cid])
+          changeTrackers[cid]->erase(entityId);
+      }
+    }
+
+    storage.destroyAll(members, used);
+
+    // A member can only be in a group if the union of signatures covers it
+    for (auto &group : groups) {
+      if ((used & group->signature()) == group->signature())
+        group->removeEntities(members);
+    }
+
+    for (EntityId entityId : members.entities())
+      entities.release(entityIndex(entityId));
+    members.clear();
+  }
+
+  /*
+   * Return true if the handle refers to a live entity. Handles to destroyed
+   * entities fail the generation check.
+   */
+  bool valid(EntityId entityId) const {
+    return entities.valid(entityId);
+  }
+
   /*
    * Add component to entity and initialise
    */
   template<typename T, typename... TArgs>
   T& addComponent(EntityId entityId, TArgs&&... mArgs) {
     // Make sure the entity exists
-    assert(entityMap.contains(entityId) && "Entity not found!");
-    Entity* entity = entityMap[entityId].get();
+    assert(valid(entityId) && "Entity not found!");
+    Entity& entity = entities[entityIndex(entityId)];
 
     // An entity cannot have more than one component of the same type
     ComponentId cid = getComponentId<T>();
-    assert(!entity->componentBitset[cid] &&
+    assert(!entity.componentBitset[cid] &&
            "Component exists for entity!");
 
-    // Set component bit
-    entity->componentBitset[cid] = true;
+    // Create the component, then set component bit
+    T& component = storage.template add<T>(
+        entityId, std::forward<TArgs>(mArgs)...);
+    entity.componentBitset[cid] = true;
+    refreshGroups(entityId, entity.componentBitset);
 
-    // Create the component
-    T component(std::forward<TArgs>(mArgs)...);
-
-    // Create component array if it doesn't exist
-    if (!componentArrays.contains(cid)) {
-        componentArrays[cid] = std::make_unique<ComponentArray<T>>();
-    }
+    // A new component counts as a change, so consumers of changes pick it up
+    if (changeTrackers[cid])
+      changeTrackers[cid]->mark(entityId, ++version);
+    notify(hooks[cid].onAdd, entityId);
 
-    // Get component array and add component
-    auto* typedArray = static_cast<ComponentArray<T>*>(componentArrays[cid].get());
-    return typedArray->addComponent(entityId, component);
+    return component;
   };
 
   /*
@@ -139,20 +276,25 @@ public:
   template<typename T, typename... TArgs>
   void removeComponent(EntityId entityId) {
     // Make sure the entity exists
-    assert(entityMap.contains(entityId) && "Entity not found!");
+    assert(valid(entityId) && "Entity not found!");
 
-    // Get entity pointer and component ID
-    Entity* entity = entityMap[entityId].get();
+    // Get entity and component ID
+    Entity& entity = entities[entityIndex(entityId)];
     ComponentId cid = getComponentId<T>();
 
     // An entity cannot have more than one component of the same type
-    assert(entity->componentBitset[cid] &&
+    assert(entity.componentBitset[cid] &&
            "Component does not exist for entity!");
 
+    // Observers see the component before it goes
+    notify(hooks[cid].onRemove, entityId);
+    if (changeTrackers[cid])
+      changeTrackers[cid]->erase(entityId);
+
     // Now we can remove it
-    entity->componentBitset[cid] = false;
-    auto* typedArray = static_cast<ComponentArray<T>*>(componentArrays[cid].get());
-    typedArray->removeComponent(entityId);
+    entity.componentBitset[cid] = false;
+    refreshGroups(entityId, entity.componentBitset);
+    storage.template remove<T>(entityId);
   }
 
   /*
@@ -170,13 +312,11 @@ public:
   template<typename T>
   T& getComponent(EntityId entityId) {
     // Make sure the entity exists and has this component
-    assert(entityMap.contains(entityId) && "Entity not found!");
+    assert(valid(entityId) && "Entity not found!");
     assert(hasComponent<T>(entityId) && "Entity does not have this component!");
 
     // Get component and return pointer to it
-    ComponentId cid = getComponentId<T>();
-    auto* typedArray = static_cast<ComponentArray<T>*>(componentArrays[cid].get());
-    return typedArray->getComponent(entityId);
+    return storage.template get<T>(entityId);
   }
 
   /*
@@ -185,81 +325,330 @@ public:
    */
   template<typename T>
   T* tryGetComponent(EntityId entityId) {
-    if (!entityMap.contains(entityId) || !hasComponent<T>(entityId))
+    if (!hasComponent<T>(entityId))
       return nullptr;
 
     // Get component and return pointer to it
-    ComponentId cid = getComponentId<T>();
-    auto* typedArray = static_cast<ComponentArray<T>*>(componentArrays[cid].get());
-    return &typedArray->getComponent(entityId);
+    return &storage.template get<T>(entityId);
   }
 
   /*
    * Return true if all components of a given type are held
-   * by the entity
+   * by the entity, with one masked compare of its signature
    */
   template<typename... ComponentTypes>
   bool hasComponents(const EntityId entityId) {
-    return (hasComponent<ComponentTypes>(entityId) && ...);
+    Signature mask = makeSignature<ComponentTypes...>();
+    return valid(entityId) &&
+           (entities[entityIndex(entityId)].componentBitset & mask) == mask;
   }
 
   /*
   * Return true if entity has component and false otherwise.
-  * Component must exist in the component lookup.
+  * Handles to destroyed entities have no components.
   */
   template<typename T>
   bool hasComponent(EntityId entityId) {
     ComponentId cid = getComponentId<T>();
-    return entityMap[entityId]->componentBitset[cid];
+    return valid(entityId) &&
+           entities[entityIndex(entityId)].componentBitset[cid];
   }
 
   /*
    * Get all components of type T and return vector of entity IDs
-   * that have those components.
+   * that have those components. Prefer view(), which doesn't allocate.
    */
   template<typename... ComponentTypes>
   std::vector<EntityId> getEntitiesWithComponents() {
     std::vector<EntityId> result = {};
 
-    for (auto& [id, entity] : entityMap) {
-      if (entity && hasComponents<ComponentTypes...>(id)) {
-        result.push_back(id);
-      }
+    for (auto entry : view<ComponentTypes...>()) {
+      result.push_back(std::get<0>(entry));
     }
 
     return result;
   }
 
   /*
-   * Remove the entity from the registry.
+   * Make room for count more entities with components Ts, so creating them
+   * doesn't reallocate storage part way through
+   */
+  template<typename... Ts>
+  void reserve(std::size_t count) {
+    entities.reserve(count);
+    (storage.template reserve<Ts>(count), ...);
+  }
+
+  /*
+   * Return a view over all entities that have every component in Ts. With
+   * sparse-set storage the view iterates the smallest of the component arrays
+   * involved; with archetype storage it walks the matching chunks.
+   */
+  template<typename... Ts>
+  auto view() {
+    static_assert(sizeof...(Ts) > 0, "View needs at least one component");
+    return storage.template view<Ts...>(entities.records());
+  }
+
+  /*
+   * Return a view over a persistent group of the entities that have every
+   * component in Ts. The group is created on first use and kept up to date as
+   * components are added and removed, which makes repeated iteration cheaper
+   * than view() at the cost of a little bookkeeping on every change.
+   */
+  template<typename... Ts>
+  auto group() {
+    static_assert(sizeof...(Ts) > 0, "Group needs at least one component");
+
+    Signature mask = makeSignature<Ts...>();
+    Group *group = nullptr;
+    for (auto &existing : groups) {
+      if (existing->signature() == mask) {
+        group = existing.get();
+        break;
+      }
+    }
+
+    // Populate a new group from the existing entities
+    if (!group) {
+      group = groups.emplace_back(std::make_unique<Group>(mask)).get();
+      entities.eachAlive([group](EntityId entityId, Entity &entity) {
+        group->refresh(entityId, entity.componentBitset);
+      });
+    }
+
+    return storage.template view<Ts...>(group->entities(), entities.records());
+  }
+
+  /*
+   * Start recording changes to components of type T. Only tracked types pay
+   * for bookkeeping on add and markChanged().
+   */
+  template<typename T>
+  void trackChanges() {
+    ComponentId cid = getComponentId<T>();
+    if (changeTrackers[cid])
+      return;
+
+    // Existing components count as changed
+    changeTrackers[cid] = std::make_unique<ChangeTracker>();
+    std::uint64_t current = ++version;
+    entities.eachAlive([&](EntityId entityId, Entity &entity) {
+      if (entity.componentBitset[cid])
+        changeTrackers[cid]->mark(entityId, current);
+    });
+  }
+
+  /*
+   * Record that the entity's component of type T has been modified and call
+   * its onChange observers. Not thread safe: call it from the main thread,
+   * before or after a parallelEach(), never from inside one.
+   */
+  template<typename T>
+  void markChanged(EntityId entityId) {
+    assert(hasComponent<T>(entityId) && "Entity does not have this component!");
+    ComponentId cid = getComponentId<T>();
+    if (changeTrackers[cid])
+      changeTrackers[cid]->mark(entityId, ++version);
+    notify(hooks[cid].onChange, entityId);
+  }
+
+  /*
+   * Modify a component in place through func(T&) and mark it changed
+   */
+  template<typename T, typename Func>
+  T& patch(EntityId entityId, Func func) {
+    T& component = getComponent<T>(entityId);
+    func(component);
+    markChanged<T>(entityId);
+    return component;
+  }
+
+  /*
+   * Call func(entity, T&) for every entity whose T was added or marked
+   * changed after the given version. Consumers typically store
+   * changeVersion() before processing and pass it in next time.
+   */
+  template<typename T, typename Func>
+  void eachChanged(std::uint64_t since, Func func) {
+    assert(changeTrackers[getComponentId<T>()] &&
+           "Changes to this component are not tracked!");
+    ChangeTracker &tracker = *changeTrackers[getComponentId<T>()];
+    const std::vector<EntityId> &changed = tracker.entities();
+    for (std::size_t index = 0; index < changed.size(); index++) {
+      if (tracker.versionAt(index) > since)
+        func(changed[index], storage.template get<T>(changed[index]));
+    }
+  }
+
+  /*
+   * Return true if the entity's T was added or marked changed after the
+   * given version
+   */
+  template<typename T>
+  bool changedSince(EntityId entityId, std::uint64_t since) const {
+    const ChangeTracker *tracker = changeTrackers[getComponentId<T>()].get();
+    assert(tracker && "Changes to this component are not tracked!");
+    std::size_t index = tracker->indexOf(entityId);
+    return index != SparseSet::nullIndex && tracker->versionAt(index) > since;
+  }
+
+  // Version of the most recent change. Increases with every change.
+  std::uint64_t changeVersion() const { return version; }
+
+  /*
+   * Forget changes made before the given version. The Engine calls this once
+   * a frame, so changes stay visible for one full frame after they are made.
+   */
+  void trimChanges(std::uint64_t before) {
+    for (auto &tracker : changeTrackers) {
+      if (tracker)
+        tracker->trim(before);
+    }
+  }
+
+  /*
+   * Register observers called after a T is added, before a T is removed
+   * (including when its entity is destroyed) and when a T is marked changed
+   */
+  template<typename T>
+  void onAdd(ComponentObserver observer) {
+    hooks[getComponentId<T>()].onAdd.push_back(std::move(observer));
+  }
+
+  template<typename T>
+  void onRemove(ComponentObserver observer) {
+    hooks[getComponentId<T>()].onRemove.push_back(std::move(observer));
+  }
+
+  template<typename T>
+  void onChange(ComponentObserver observer) {
+    hooks[getComponentId<T>()].onChange.push_back(std::move(observer));
+  }
+
+  /*
+   * Remove the entity from the registry. Its slot is recycled by a later
+   * create() under a new generation.
    */
   void destroy(EntityId entityId) {
     // Do nothing if entity doesn't exist
-    if (!entityMap.contains(entityId))
+    if (!valid(entityId))
       return;
 
-    // Remove all components from entity
-    for (auto& [cid, array] : componentArrays) {
-        array->removeComponent(entityId);
-    }
+    // Remove only the components the entity actually has
+    Entity& entity = entities[entityIndex(entityId)];
+    forgetComponents(entityId, entity.componentBitset);
+    storage.destroy(entityId, entity.componentBitset);
+    refreshGroups(entityId, Signature());
+    if (entity.scope != globalScope)
+      scopeMembers(entity.scope).remove(entityId);
 
-    entityMap.erase(entityId);
+    entities.release(entityIndex(entityId));
   }
 
   /*
-  * Clear all entities in the registry and reset entity ID
-  * Components lookup is not cleared to allow reuse
+  * Clear all entities in the registry. Slots are kept for reuse and their
+  * generations bumped, so handles from before the clear stay invalid.
   */
   void clear() {
-    entityMap.clear();
-    componentArrays.clear();
-    entityIdCounter = 0;
+    entities.eachAlive([this](EntityId entityId, Entity &entity) {
+      notifyRemoved(entityId, entity.componentBitset);
+    });
+
+    storage.clear();
+    for (auto &group : groups)
+      group->clear();
+    for (auto &scope : scopes)
+      scope->clear();
+    for (auto &tracker : changeTrackers) {
+      if (tracker)
+        tracker->clear();
+    }
+    entities.releaseAll();
   };
 
+  /*
+   * Every entity slot, live or free, indexed by entity index. Used to save
+   * the entity table.
+   */
+  const std::vector<Entity>& entityRecords() const {
+    return entities.records();
+  }
+
+  /*
+   * Clear the registry and replace its entity table with saved slots, so the
+   * live ones come back under their saved handles and scopes. Scopes that
+   * don't exist yet are created. Components are added back afterwards.
+   */
+  void restoreEntities(std::vector<Entity> records) {
+    clear();
+    for (std::uint32_t index = 0; index < records.size(); index++) {
+      const Entity &record = records[index];
+      if (!record.alive || record.scope == globalScope)
+        continue;
+      while (scopes.size() < record.scope)
+        createScope();
+      scopeMembers(record.scope).add(makeEntityId(index, record.generation));
+    }
+    entities.assign(std::move(records));
+  }
+
   ~EntityRegistry() = default;
 
 private:
-  std::unordered_map<EntityId, std::unique_ptr<Entity>> entityMap = {};
-  std::unordered_map<ComponentId, std::unique_ptr<IComponentArray>> componentArrays = {};
-  EntityId entityIdCounter = 0;
+  EntityTable<Entity> entities = {};
+
+  ComponentStorage storage = {};
+  std::vector<std::unique_ptr<Group>> groups = {};
+
+  // Members of each scope, indexed by scope ID - 1 (the global scope has no
+  // member list)
+  std::vector<std::unique_ptr<ScopeMembers>> scopes = {};
+
+  struct ComponentHooks {
+    std::vector<ComponentObserver> onAdd = {};
+    std::vector<ComponentObserver> onRemove = {};
+    std::vector<ComponentObserver> onChange = {};
+  };
+
+  // Indexed by component ID. Sized up front so systems touching different
+  // component types never resize them concurrently.
+  std::array<ComponentHooks, maxComponents> hooks = {};
+  std::array<std::unique_ptr<ChangeTracker>, maxComponents> changeTrackers = {};
+  std::atomic<std::uint64_t> version = 0;
+
+  void notify(const std::vector<ComponentObserver> &observers,
+              EntityId entityId) {
+    for (auto &observer : observers)
+      observer(*this, entityId);
+  }
+
+  void notifyRemoved(EntityId entityId, const Signature &signature) {
+    for (std::size_t cid = 0; cid < maxComponents; cid++) {
+      if (signature[cid])
+        notify(hooks[cid].onRemove, entityId);
+    }
+  }
+
+  /*
+   * Call onRemove observers and drop change records for all of the entity's
+   * components
+   */
+  void forgetComponents(EntityId entityId, const Signature &signature) {
+    notifyRemoved(entityId, signature);
+    for (std::size_t cid = 0; cid < maxComponents; cid++) {
+      if (signature[cid] && changeTrackers[cid])
+        changeTrackers[cid]->erase(entityId);
+    }
+  }
+
+  ScopeMembers& scopeMembers(ScopeId scope) {
+    assert(scope != globalScope && scope <= scopes.size() && "Scope not found!");
+    return *scopes[scope - 1];
+  }
+
+  void refreshGroups(EntityId entityId, const Signature &signature) {
+    for (auto &group : groups)
+      group->refresh(entityId, signature);
+  }
 };
@@ -0,0 +1,223 @@
+#pragma once
+
+#include <atomic>
+#include <bitset>
+#include <cassert>
+#include <cstdint>
+#include <cstddef>
+#include <utility>
+#include <vector>
+
+// Number of component types EntityRegistry supports. Define
+// PANGOLENGINE_MAX_COMPONENTS to raise it (up to 255, so the type past the
+// limit still gets an ID the "too many" asserts catch before IDs wrap); the
+// compile-time Registry<Ts...> sizes its signatures from its component list
+// instead.
+#ifndef PANGOLENGINE_MAX_COMPONENTS
+#define PANGOLENGINE_MAX_COMPONENTS 32
+#endif
+
+constexpr std::size_t maxComponents = PANGOLENGINE_MAX_COMPONENTS;
+static_assert(maxComponents <= 255, "Component IDs are 8-bit");
+
+//------------------------------------------------------------------------------
+// Entity
+//------------------------------------------------------------------------------
+
+/*
+ * Entity IDs are 32-bit handles made of a slot index (low bits) and a
+ * generation (high bits). A slot's generation is bumped whenever its entity is
+ * destroyed, so a handle to a destroyed entity no longer matches its slot even
+ * after the slot has been reused.
+ */
+using EntityId = std::uint32_t;
+
+constexpr std::uint32_t entityIndexBits = 20;
+constexpr std::uint32_t entityIndexMask = (1u << entityIndexBits) - 1;
+constexpr std::uint32_t entityGenerationMask = (1u << (32 - entityIndexBits)) - 1;
+constexpr std::size_t maxEntities = std::size_t(entityIndexMask) + 1;
+
+// Generations start at 1, so 0 is never a valid handle
+constexpr EntityId nullEntity = 0;
+
+constexpr std::uint32_t entityIndex(EntityId entityId) {
+  return entityId & entityIndexMask;
+}
+
+constexpr std::uint32_t entityGeneration(EntityId entityId) {
+  return entityId >> entityIndexBits;
+}
+
+constexpr EntityId makeEntityId(std::uint32_t index, std::uint32_t generation) {
+  return (generation << entityIndexBits) | (index & entityIndexMask);
+}
+
+using Signature = std::bitset<maxComponents>;
+
+/*
+ * Scopes group entities that share a lifetime (e.g. everything loaded with a
+ * map) so they can be destroyed together. Entities in the global scope live
+ * until they are destroyed individually or the registry is cleared.
+ */
+using ScopeId = std::uint8_t;
+constexpr ScopeId globalScope = 0;
+
+template<typename SignatureT>
+struct BasicEntity {
+  SignatureT componentBitset = {};
+  std::uint16_t generation = 1;
+  ScopeId scope = globalScope;
+  bool alive = false;
+};
+
+using Entity = BasicEntity<Signature>;
+
+/*
+ * Entity slots indexed by entity index. Destroyed slots go on a free list and
+ * are reused under a new generation.
+ */
+template<typename EntityT>
+class EntityTable {
+public:
+  /*
+   * Take a slot (reusing a free one if possible) and return its handle
+   */
+  EntityId create() {
+    std::uint32_t index;
+    if (!freeIndices.empty()) {
+      index = freeIndices.back();
+      freeIndices.pop_back();
+    } else {
+      assert(slots.size() < maxEntities && "Too many entities!");
+      index = static_cast<std::uint32_t>(slots.size());
+      slots.emplace_back();
+    }
+
+    EntityT& entity = slots[index];
+    entity.alive = true;
+    return makeEntityId(index, entity.generation);
+  }
+
+  /*
+   * Return true if the handle refers to a live entity. Handles to destroyed
+   * entities fail the generation check.
+   */
+  bool valid(EntityId entityId) const {
+    std::uint32_t index = entityIndex(entityId);
+    return index < slots.size() && slots[index].alive &&
+           slots[index].generation == entityGeneration(entityId);
+  }
+
+  /*
+   * Mark a slot as dead, bump its generation and add it to the free list
+   */
+  void release(std::uint32_t index) {
+    EntityT& entity = slots[index];
+    entity.componentBitset.reset();
+    entity.scope = globalScope;
+    entity.alive = false;
+
+    // Skip generation 0 on wrap-around so nullEntity is never issued
+    entity.generation = (entity.generation + 1) & entityGenerationMask;
+    if (entity.generation == 0)
+      entity.generation = 1;
+
+    freeIndices.push_back(index);
+  }
+
+  /*
+   * Release every live slot. The free list is rebuilt so that low indices
+   * are reused first.
+   */
+  void releaseAll() {
+    freeIndices.clear();
+    for (std::uint32_t index = static_cast<std::uint32_t>(slots.size());
+         index-- > 0;) {
+      if (slots[index].alive)
+        release(index);
+      else
+        freeIndices.push_back(index);
+    }
+  }
+
+  /*
+   * Call func(entityId, entity) for every live entity
+   */
+  template<typename Func>
+  void eachAlive(Func func) {
+    for (std::uint32_t index = 0; index < slots.size(); index++) {
+      if (slots[index].alive)
+        func(makeEntityId(index, slots[index].generation), slots[index]);
+    }
+  }
+
+  /*
+   * Make room for count more entities without reallocating the table
+   */
+  void reserve(std::size_t count) {
+    if (count > freeIndices.size())
+      slots.reserve(slots.size() + count - freeIndices.size());
+  }
+
+  /*
+   * Replace the table with the given slots, e.g. when loading a snapshot.
+   * Component bits are cleared, since components are added back separately,
+   * and the free list is rebuilt from the dead slots.
+   */
+  void assign(std::vector<EntityT> records) {
+    slots = std::move(records);
+    freeIndices.clear();
+    for (std::uint32_t index = static_cast<std::uint32_t>(slots.size());
+         index-- > 0;) {
+      slots[index].componentBitset.reset();
+      if (!slots[index].alive) {
+        slots[index].scope = globalScope;
+        freeIndices.push_back(index);
+      }
+    }
+  }
+
+  EntityT& operator[](std::uint32_t index) { return slots[index]; }
+  const EntityT& operator[](std::uint32_t index) const { return slots[index]; }
+  std::size_t size() const { return slots.size(); }
+
+  // All slots, live or free, indexed by entity index
+  const std::vector<EntityT>& records() const { return slots; }
+
+private:
+  std::vector<EntityT> slots = {};
+  std::vector<std::uint32_t> freeIndices = {};
+};
+
+//------------------------------------------------------------------------------
+// Components
+//------------------------------------------------------------------------------
+
+using ComponentId = std::uint8_t;
+class ComponentIdGenerator {
+private:
+    // Atomic so systems running on worker threads can look up IDs safely
+    static inline std::atomic<ComponentId> nextId = 0;
+
+public:
+    template<typename T>
+    static ComponentId getId() {
+        static ComponentId id = nextId.fetch_add(1);
+        return id;
+    }
+};
+
+template<typename T>
+ComponentId getComponentId() {
+    return ComponentIdGenerator::getId<T>();
+}
+
+/*
+ * Return the signature with a bit set for each component type in Ts
+ */
+template<typename... Ts>
+Signature makeSignature() {
+  Signature mask;
+  (mask.set(getComponentId<Ts>()), ...);
+  return mask;
+}
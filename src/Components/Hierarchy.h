@@ -0,0 +1,230 @@
+#pragma once
+
+#include "../Vector2D.h"
+#include "ECS.h"
+#include "Snapshot.h"
+#include "StoragePolicy.h"
+#include "Transform.h"
+#include <algorithm>
+#include <cassert>
+#include <cstdint>
+#include <unordered_map>
+#include <vector>
+
+/*
+ * Makes an entity the child of another. The child's Transform holds its world
+ * position, which TransformHierarchy keeps at the parent's position plus
+ * this local position, so children (colliders, interaction areas, sprites...)
+ * follow their parent when it moves. Move a child relative to its parent by
+ * patching its LocalTransform rather than its Transform.
+ */
+struct LocalTransform {
+  // Only children have one
+  static constexpr StoragePolicy storagePolicy = StoragePolicy::Sparse;
+
+  EntityId parent = nullEntity;
+  Vector2D position = {0, 0};
+
+  /*
+   * Snapshot hooks, so the parent handle is translated when a scope is
+   * restored under new handles
+   */
+  void saveSnapshot(SnapshotWriter &out) const {
+    out.write(parent);
+    out.write(position);
+  }
+
+  static LocalTransform loadSnapshot(SnapshotReader &in) {
+    LocalTransform local;
+    local.parent = in.entity(in.read<EntityId>());
+    local.position = in.read<Vector2D>();
+    return local;
+  }
+};
+
+/*
+ * Propagates parent transforms to their children. The children are kept in
+ * one flat array sorted by depth, so every parent comes before its children
+ * and a single pass over the array updates the whole hierarchy. A child is
+ * only recomputed when its parent's Transform or its own LocalTransform has
+ * changed since the last pass; recomputing it marks its Transform changed in
+ * turn, so dirtiness flows down the subtree and untouched subtrees are
+ * skipped.
+ *
+ * The array is rebuilt whenever children are added, reparented or removed.
+ * Children whose parent has been destroyed are left where they are.
+ */
+class TransformHierarchy {
+public:
+  struct Node {
+    EntityId entity;
+    EntityId parent;
+    std::uint32_t depth;
+  };
+
+  explicit TransformHierarchy(EntityRegistry &registry) {
+    registry.trackChanges<Transform>();
+    registry.trackChanges<LocalTransform>();
+  }
+
+  /*
+   * Make child a child of parent, keeping the child where it currently is
+   */
+  static void attach(EntityRegistry &registry, EntityId child,
+                     EntityId parent) {
+    assert(child != parent && "An entity can't be its own parent!");
+    assert(!isAncestor(registry, child, parent) &&
+           "Attaching would create a cycle!");
+
+    const Vector2D &childPosition =
+        registry.getComponent<Transform>(child).position;
+    const Vector2D &parentPosition =
+        registry.getComponent<Transform>(parent).position;
+    LocalTransform local = {parent, Vector2D(childPosition.x - parentPosition.x,
+                                             childPosition.y - parentPosition.y)};
+
+    if (registry.hasComponent<LocalTransform>(child))
+      registry.patch<LocalTransform>(
+          child, [&local](LocalTransform &current) { current = local; });
+    else
+      registry.addComponent<LocalTransform>(child, local);
+  }
+
+  /*
+   * Detach child from its parent. It stays at its current world position.
+   */
+  static void detach(EntityRegistry &registry, EntityId child) {
+    if (registry.hasComponent<LocalTransform>(child))
+      registry.removeComponent<LocalTransform>(child);
+  }
+
+  /*
+   * Bring every child's world position up to date. Call once per frame, after
+   * anything that moves parents.
+   */
+  void propagate(EntityRegistry &registry) {
+    if (structureChanged(registry))
+      rebuild(registry);
+
+    std::uint64_t since = lastVersion;
+    for (const Node &node : nodes) {
+      if (!registry.changedSince<Transform>(node.parent, since) &&
+          !registry.changedSince<LocalTransform>(node.entity, since))
+        continue;
+
+      const Vector2D &parentPosition =
+          registry.getComponent<Transform>(node.parent).position;
+      const Vector2D &local =
+          registry.getComponent<LocalTransform>(node.entity).position;
+      Vector2D world(parentPosition.x + local.x, parentPosition.y + local.y);
+
+      registry.patch<Transform>(node.entity, [&world](Transform &transform) {
+        transform.position = world;
+        transform.startPosition = world;
+        transform.targetPosition = world;
+      });
+    }
+    lastVersion = registry.changeVersion();
+  }
+
+  // Children in the order they are updated, parents before children
+  const std::vector<Node>& order() const { return nodes; }
+
+private:
+  std::vector<Node> nodes = {};
+  std::unordered_map<EntityId, std::uint32_t> nodeIndex = {};
+  std::uint64_t lastVersion = 0;
+
+  static bool isAncestor(EntityRegistry &registry, EntityId ancestor,
+                         EntityId entity) {
+    while (LocalTransform *local =
+               registry.tryGetComponent<LocalTransform>(entity)) {
+      if (local->parent == ancestor)
+        return true;
+      entity = local->parent;
+    }
+    return false;
+  }
+
+  /*
+   * Return true if a child was added or reparented since the last pass, or
+   * one of the known children (or its parent) has gone
+   */
+  bool structureChanged(EntityRegistry &registry) {
+    for (const Node &node : nodes) {
+      if (!registry.hasComponent<LocalTransform>(node.entity) ||
+          !registry.hasComponent<Transform>(node.parent))
+        return true;
+    }
+
+    bool changed = false;
+    registry.eachChanged<LocalTransform>(lastVersion,
+      [&](EntityId entityId, LocalTransform &local) {
+        auto found = nodeIndex.find(entityId);
+        changed = changed || found == nodeIndex.end() ||
+                  nodes[found->second].parent != local.parent;
+      });
+    return changed;
+  }
+
+  /*
+   * Collect every child whose parent is still alive, work out its depth and
+   * sort parents before children
+   */
+  void rebuild(EntityRegistry &registry) {
+    nodes.clear();
+    nodeIndex.clear();
+
+    std::unordered_map<EntityId, std::uint32_t> depths;
+    std::vector<EntityId> chain;
+    for (auto [entityId, local] : registry.view<LocalTransform>()) {
+      // Walk up until an entity whose depth is known or which isn't a child,
+      // then fill in depths on the way back down
+      chain.clear();
+      EntityId current = entityId;
+      std::uint32_t depth = 0;
+      bool attached = true;
+      while (true) {
+        auto known = depths.find(current);
+        if (known != depths.end()) {
+          depth = known->second;
+          break;
+        }
+        LocalTransform *link = registry.tryGetComponent<LocalTransform>(current);
+        if (!link)
+          break;
+        if (!registry.hasComponent<Transform>(current) ||
+            !registry.hasComponent<Transform>(link->parent)) {
+          attached = false;
+          break;
+        }
+        chain.push_back(current);
+        if (chain.size() > registry.entityRecords().size()) {
+          assert(false && "Transform hierarchy has a cycle!");
+          attached = false;
+          break;
+        }
+        current = link->parent;
+      }
+
+      // Children of detached entities aren't updated either
+      if (!attached || depth == std::uint32_t(-1)) {
+        for (EntityId member : chain)
+          depths[member] = std::uint32_t(-1);
+        continue;
+      }
+      for (auto member = chain.rbegin(); member != chain.rend(); ++member)
+        depths[*member] = ++depth;
+
+      nodes.push_back({entityId, local.parent, depths[entityId]});
+    }
+
+    std::stable_sort(nodes.begin(), nodes.end(),
+                     [](const Node &a, const Node &b) {
+                       return a.depth < b.depth;
+                     });
+    nodeIndex.reserve(nodes.size());
+    for (std::uint32_t index = 0; index < nodes.size(); index++)
+      nodeIndex[nodes[index].entity] = index;
+  }
+};
@@ -2,10 +2,14 @@
 
 #include "SDL3/SDL_rect.h"
 #include "Transform.h"
+#include "StoragePolicy.h"
 #include <iostream>
 
 class Interactable {
 public:
+  // Only a few entities per map have one
+  static constexpr StoragePolicy storagePolicy = StoragePolicy::Sparse;
+
   SDL_FRect interactArea;
   Offset offset;
   bool canInteract = false;
@@ -4,9 +4,13 @@
 #include "SDL3/SDL_events.h"
 #include "Sprite.h"
 #include "Transform.h"
+#include "StoragePolicy.h"
 
 class KeyboardController {
 public:
+  // Only the player has one
+  static constexpr StoragePolicy storagePolicy = StoragePolicy::Singleton;
+
   KeyboardController() = default;
 
   void update(SDL_Event *event, bool menuActive, Transform &transform,
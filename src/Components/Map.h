@@ -1,20 +1,45 @@
 #pragma once
 
 #include "../Camera.h"
+#include "../Engine.h"
 #include "../MapLoader.h"
 #include "../TextureManager.h"
 #include "../Vector2D.h"
+#include "SDL3/SDL_log.h"
 #include "SDL3/SDL_render.h"
 #include "SDL3/SDL_surface.h"
+#include "Snapshot.h"
+#include "StoragePolicy.h"
+#include <algorithm>
+#include <cassert>
+#include <string>
+#include <vector>
 
 class Map {
 public:
+  // Only the current map has one
+  static constexpr StoragePolicy storagePolicy = StoragePolicy::Singleton;
+
+  /*
+   * Tiles are stored once, in world space, row by row. Only the tiles inside
+   * the camera's view are visited each frame, so the per-frame cost depends on
+   * the screen size rather than the size of the map.
+   */
   struct Tile {
-    Vector2D position;
-    Vector2D mapPosition;
-    int width, height;
-    int index;
-    SDL_Texture *texture;
+    SDL_FRect srcRect; // cell of the tileset
+    bool empty;        // no tile here (Tiled GID 0)
+  };
+
+  /*
+   * The tile layer is also baked into render-target textures, one per block
+   * of chunkTiles x chunkTiles tiles, so a frame draws a few chunks instead
+   * of every visible tile. Editing a tile only rebakes its chunk.
+   */
+  static constexpr int chunkTiles = 16;
+
+  struct Chunk {
+    SDL_Texture *texture = nullptr;
+    bool dirty = true;
   };
 
   Map(MapData *mapData, const char *tileMapImage, int tileSize) {
@@ -22,62 +47,259 @@ public:
 
     this->tileSize = tileSize;
     this->mapData = mapData;
+    columns = int(mapData->width);
+    rows = int(mapData->height);
 
-    srcRect.x = srcRect.y = 0;
-    destRect.x = destRect.y = 0;
+    tileMapPath = tileMapImage;
+    tileMapTex = TextureManager::AcquireTexture(tileMapPath);
 
-    srcRect.w = destRect.w = float(tileSize);
-    srcRect.h = destRect.h = float(tileSize);
+    // Work out each tile's cell in the tileset once, rather than every time
+    // it is drawn
+    tiles.reserve(std::size_t(rows) * std::size_t(columns));
+    for (int row = 0; row < rows; row++) {
+      for (int col = 0; col < columns; col++)
+        tiles.push_back(makeTile(mapData->map[row][col] - 1));
+    }
 
-    tileMapTex = TextureManager::LoadTexture(tileMapImage);
+    chunkColumns = (columns + chunkTiles - 1) / chunkTiles;
+    chunkRows = (rows + chunkTiles - 1) / chunkTiles;
+    chunks.resize(std::size_t(chunkColumns) * std::size_t(chunkRows));
+    bakeChunks();
+  }
 
-    int index = 0;
-    for (int row = 0; row < mapData->height; row++) {
-      for (int col = 0; col < mapData->width; col++) {
-        index = mapData->map[row][col] - 1;
-        tiles.push_back({Vector2D(float(col) * tileSize, float(row) * tileSize),
-                         Vector2D(float(col) * tileSize, float(row) * tileSize),
-                         tileSize, tileSize, index, tileMapTex});
-      }
-    }
+  /*
+   * Change the tileset cell drawn at a map position (-1 for none). Only the
+   * chunk holding the tile is rebaked, the next time it is drawn.
+   */
+  void setTile(int col, int row, int index) {
+    assert(col >= 0 && col < columns && row >= 0 && row < rows &&
+           "Tile outside the map!");
+    tiles[std::size_t(row) * columns + col] = makeTile(index);
+    chunks[std::size_t(row / chunkTiles) * chunkColumns + col / chunkTiles]
+        .dirty = true;
   }
 
-  void render() {
-    for (auto &tile : tiles) {
-      int xidx = tile.index % (tile.texture->w / tile.width);
-      int yidx = tile.index / (tile.texture->w / tile.width);
+  /*
+   * Rebake every chunk before it is next drawn. Needed when the renderer
+   * loses the contents of its render targets (SDL_EVENT_RENDER_TARGETS_RESET).
+   */
+  void invalidate() {
+    for (Chunk &chunk : chunks)
+      chunk.dirty = true;
+  }
 
-      // Make sure index doesn't exceed the texture height
-      assert((yidx + 1) * tile.height <= tile.texture->h);
+  /*
+   * Snapshot hooks. Only the tileset and tile size are saved: the tiles are
+   * rebuilt from Engine::mapData, which must hold this map's data when the
+   * snapshot is restored.
+   */
+  void saveSnapshot(SnapshotWriter &out) const {
+    out.writeString(tileMapPath);
+    out.write(tileSize);
+  }
 
-      srcRect.x = float(xidx * tile.width);
-      srcRect.y = float(yidx * tile.height);
-      destRect.x = float(tile.position.x);
-      destRect.y = float(tile.position.y);
+  static Map loadSnapshot(SnapshotReader &in) {
+    std::string tileMapImage = in.readString();
+    int tileSize = in.read<int>();
+    if (tileSize <= 0)
+      in.fail();
 
-      TextureManager::Draw(tile.texture, srcRect, destRect, SDL_FLIP_NONE);
-    }
+    // Don't load the tileset or bake chunks for a snapshot that is discarded
+    if (!in.ok())
+      return Map();
+    return Map(&Engine::mapData, tileMapImage.c_str(), tileSize);
   }
 
-  void update() {
-    for (auto &tile : tiles) {
-      tile.position.x = tile.mapPosition.x - Camera::position.x;
-      tile.position.y = tile.mapPosition.y - Camera::position.y;
+  /*
+   * Draw the chunks overlapping the camera's view, baking any that are out of
+   * date first. Falls back to drawing tiles one by one if render targets
+   * aren't available. The view is worked out here rather than in update(),
+   * which runs before the camera follows the player each frame.
+   */
+  void render() {
+    TileRange visible = visibleTiles();
+    if (!useChunks) {
+      renderTiles(visible);
+      return;
+    }
+
+    int lastChunkRow = (visible.lastRow + chunkTiles - 1) / chunkTiles;
+    int lastChunkColumn = (visible.lastColumn + chunkTiles - 1) / chunkTiles;
+    for (int chunkRow = visible.firstRow / chunkTiles; chunkRow < lastChunkRow;
+         chunkRow++) {
+      for (int chunkCol = visible.firstColumn / chunkTiles;
+           chunkCol < lastChunkColumn; chunkCol++) {
+        Chunk &chunk = chunks[std::size_t(chunkRow) * chunkColumns + chunkCol];
+        if (chunk.dirty && !bakeChunk(chunkCol, chunkRow)) {
+          renderTiles(visible);
+          return;
+        }
+
+        SDL_FRect srcRect = {0, 0, float(chunk.texture->w),
+                             float(chunk.texture->h)};
+        SDL_FRect destRect = {
+            float(chunkCol * chunkTiles * tileSize - Camera::position.x),
+            float(chunkRow * chunkTiles * tileSize - Camera::position.y),
+            srcRect.w, srcRect.h};
+        TextureManager::Draw(chunk.texture, srcRect, destRect, SDL_FLIP_NONE);
+      }
     }
   }
 
   void clean() {
-    SDL_DestroyTexture(tileMapTex);
+    TextureManager::ReleaseTexture(tileMapTex);
+    tileMapTex = nullptr;
+    for (Chunk &chunk : chunks)
+      SDL_DestroyTexture(chunk.texture);
+    chunks.clear();
     tiles.clear();
+    columns = rows = 0;
   }
 
   ~Map() {}
 
 private:
-  int tileSize;
-  MapData *mapData;
+  int tileSize = 0;
+  int columns = 0, rows = 0;
+  MapData *mapData = nullptr;
   std::vector<Tile> tiles;
 
-  SDL_FRect srcRect, destRect;
-  SDL_Texture *tileMapTex;
+  // Rows and columns of tiles, end exclusive
+  struct TileRange {
+    int firstColumn, lastColumn;
+    int firstRow, lastRow;
+  };
+
+  std::vector<Chunk> chunks;
+  int chunkColumns = 0, chunkRows = 0;
+  bool useChunks = true;
+
+  std::string tileMapPath;
+  SDL_Texture *tileMapTex = nullptr;
+
+  // Holds nothing; only returned in place of a map that couldn't be loaded
+  Map() = default;
+
+  Tile makeTile(int index) const {
+    int tilesetColumns = tileMapTex ? tileMapTex->w / tileSize : 0;
+    if (index < 0 || tilesetColumns == 0)
+      return {{0, 0, 0, 0}, true};
+
+    int xidx = index % tilesetColumns;
+    int yidx = index / tilesetColumns;
+
+    // Make sure index doesn't exceed the texture height
+    assert((yidx + 1) * tileSize <= tileMapTex->h);
+
+    return {{float(xidx * tileSize), float(yidx * tileSize), float(tileSize),
+             float(tileSize)},
+            false};
+  }
+
+  /*
+   * Work out which rows and columns the camera can see. A tile partly in
+   * view counts as visible.
+   */
+  TileRange visibleTiles() const {
+    const SDL_Rect &view = Camera::position;
+    TileRange range;
+    range.firstColumn = std::clamp(floorDiv(view.x, tileSize), 0, columns);
+    range.lastColumn =
+        std::clamp(floorDiv(view.x + view.w + tileSize - 1, tileSize),
+                   range.firstColumn, columns);
+    range.firstRow = std::clamp(floorDiv(view.y, tileSize), 0, rows);
+    range.lastRow =
+        std::clamp(floorDiv(view.y + view.h + tileSize - 1, tileSize),
+                   range.firstRow, rows);
+    return range;
+  }
+
+  /*
+   * Draw the tiles in range one by one
+   */
+  void renderTiles(const TileRange &range) {
+    SDL_FRect destRect = {0, 0, float(tileSize), float(tileSize)};
+    for (int row = range.firstRow; row < range.lastRow; row++) {
+      const Tile *tile = &tiles[std::size_t(row) * columns + range.firstColumn];
+      destRect.y = float(row * tileSize - Camera::position.y);
+      for (int col = range.firstColumn; col < range.lastColumn; col++, tile++) {
+        if (tile->empty)
+          continue;
+        destRect.x = float(col * tileSize - Camera::position.x);
+        TextureManager::Draw(tileMapTex, tile->srcRect, destRect,
+                             SDL_FLIP_NONE);
+      }
+    }
+  }
+
+  void bakeChunks() {
+    for (int chunkRow = 0; chunkRow < chunkRows && useChunks; chunkRow++) {
+      for (int chunkCol = 0; chunkCol < chunkColumns && useChunks; chunkCol++)
+        bakeChunk(chunkCol, chunkRow);
+    }
+  }
+
+  /*
+   * Draw a chunk's tiles into its texture, creating it on first use. Edge
+   * chunks are only as large as the tiles they hold. Returns false (and
+   * stops using chunks) if the renderer can't render to textures.
+   */
+  bool bakeChunk(int chunkCol, int chunkRow) {
+    Chunk &chunk = chunks[std::size_t(chunkRow) * chunkColumns + chunkCol];
+    int firstCol = chunkCol * chunkTiles;
+    int firstRowInChunk = chunkRow * chunkTiles;
+    int width = std::min(chunkTiles, columns - firstCol);
+    int height = std::min(chunkTiles, rows - firstRowInChunk);
+
+    if (!chunk.texture) {
+      chunk.texture = SDL_CreateTexture(
+          Engine::renderer, SDL_PIXELFORMAT_RGBA8888,
+          SDL_TEXTUREACCESS_TARGET, width * tileSize, height * tileSize);
+      if (!chunk.texture) {
+        SDL_Log("Map chunks unavailable, drawing tiles directly: %s",
+                SDL_GetError());
+        useChunks = false;
+        return false;
+      }
+      SDL_SetTextureBlendMode(chunk.texture, SDL_BLENDMODE_BLEND);
+      SDL_SetTextureScaleMode(chunk.texture, SDL_SCALEMODE_NEAREST);
+    }
+
+    // Anything already queued belongs to the current target
+    TextureManager::FlushBatch();
+    SDL_Texture *previousTarget = SDL_GetRenderTarget(Engine::renderer);
+    Uint8 r, g, b, a;
+    SDL_GetRenderDrawColor(Engine::renderer, &r, &g, &b, &a);
+
+    SDL_SetRenderTarget(Engine::renderer, chunk.texture);
+    SDL_SetRenderDrawColor(Engine::renderer, 0, 0, 0, SDL_ALPHA_TRANSPARENT);
+    SDL_RenderClear(Engine::renderer);
+
+    SDL_FRect destRect = {0, 0, float(tileSize), float(tileSize)};
+    for (int row = 0; row < height; row++) {
+      const Tile *tile =
+          &tiles[std::size_t(firstRowInChunk + row) * columns + firstCol];
+      destRect.y = float(row * tileSize);
+      for (int col = 0; col < width; col++, tile++) {
+        if (tile->empty)
+          continue;
+        destRect.x = float(col * tileSize);
+        TextureManager::Draw(tileMapTex, tile->srcRect, destRect,
+                             SDL_FLIP_NONE);
+      }
+    }
+
+    TextureManager::FlushBatch();
+    SDL_SetRenderTarget(Engine::renderer, previousTarget);
+    SDL_SetRenderDrawColor(Engine::renderer, r, g, b, a);
+    chunk.dirty = false;
+    return true;
+  }
+
+  // Division rounding towards negative infinity, for camera positions left
+  // of or above the map
+  static int floorDiv(int value, int divisor) {
+    int quotient = value / divisor;
+    return (value % divisor != 0 && value < 0) ? quotient - 1 : quotient;
+  }
 };
@@ -9,6 +9,7 @@
 #include "Transform.h"
 #include "../Camera.h"
 #include "Vector2D.h"
+#include "StoragePolicy.h"
 
 struct MouseInfo {
   SDL_MouseButtonFlags flags;
@@ -18,6 +19,9 @@ struct MouseInfo {
 
 class MouseController {
 public:
+  // Only the player has one
+  static constexpr StoragePolicy storagePolicy = StoragePolicy::Singleton;
+
   MouseController() = default;
 
   void update(const MouseInfo mouseInfo, SDL_Renderer *renderer, bool menuActive,
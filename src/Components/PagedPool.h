@@ -0,0 +1,80 @@
+#pragma once
+
+#include <algorithm>
+#include <cstddef>
+#include <memory>
+#include <new>
+#include <utility>
+#include <vector>
+
+/*
+ * Allocator for objects of one type, carved out of fixed-size pages. Pages
+ * are never reallocated, so an object keeps its address for as long as it
+ * lives, and growing the pool never copies or moves existing objects. Freed
+ * slots are reused before new ones are taken from the last page.
+ *
+ * The pool doesn't track which slots are live: owners must destroy() every
+ * object they create() before the pool itself is destroyed.
+ */
+template<typename T>
+class PagedPool {
+public:
+  static constexpr std::size_t pageBytes = 16 * 1024;
+  static constexpr std::size_t pageSize =
+      std::max<std::size_t>(1, pageBytes / sizeof(T));
+
+  PagedPool() = default;
+  PagedPool(const PagedPool &) = delete;
+  PagedPool& operator=(const PagedPool &) = delete;
+
+  template<typename... TArgs>
+  T* create(TArgs&&... mArgs) {
+    void *slot = allocate();
+    return new (slot) T(std::forward<TArgs>(mArgs)...);
+  }
+
+  void destroy(T *object) {
+    object->~T();
+    freeSlots.push_back(reinterpret_cast<Slot*>(object));
+  }
+
+  /*
+   * Make sure at least count objects can be created without allocating
+   */
+  void reserve(std::size_t count) {
+    while (capacity() - liveCount() < count)
+      pages.push_back(newPage());
+  }
+
+  std::size_t capacity() const { return pages.size() * pageSize; }
+
+private:
+  struct alignas(T) Slot {
+    std::byte bytes[sizeof(T)];
+  };
+
+  std::vector<std::unique_ptr<Slot[]>> pages = {};
+  std::vector<Slot*> freeSlots = {};
+  std::size_t used = 0; // slots handed out from pages, live or freed
+
+  // Left uninitialised, since objects are constructed in place
+  static std::unique_ptr<Slot[]> newPage() {
+    return std::unique_ptr<Slot[]>(new Slot[pageSize]);
+  }
+
+  std::size_t liveCount() const { return used - freeSlots.size(); }
+
+  void* allocate() {
+    if (!freeSlots.empty()) {
+      Slot *slot = freeSlots.back();
+      freeSlots.pop_back();
+      return slot;
+    }
+
+    if (used == capacity())
+      pages.push_back(newPage());
+    Slot *slot = &pages[used / pageSize][used % pageSize];
+    ++used;
+    return slot;
+  }
+};
@@ -0,0 +1,89 @@
+#pragma once
+
+#include "ECS.h"
+#include <cstddef>
+#include <tuple>
+#include <utility>
+#include <vector>
+
+/*
+ * Blueprint for entities that share a component set. The components are
+ * described once, and every spawned entity gets copies of them, which the
+ * caller can adjust per instance (position, size, draw order...):
+ *
+ *   Transform tile(0, 0, 16, 16);
+ *   Prefab<Transform, Collider> wall(tile, Collider(0, 0, 16, 16, tile));
+ *   wall.spawn(registry, walls.size(),
+ *     [&](std::size_t i, EntityId, Transform& transform, Collider& collider) {
+ *       transform.position = walls[i].position;
+ *       collider.update(transform);
+ *     });
+ *
+ * Components that hold resources are copied with references of their own (a
+ * Sprite acquires its texture again), so every instance is cleaned on its
+ * own as usual. The blueprint keeps its references until it is cleaned too,
+ * with get<Sprite>().clean() for instance.
+ *
+ * Spawning many instances at once reserves entity and component storage up
+ * front, so the batch never reallocates part way through. Archetype storage
+ * has no component storage to reserve (its chunks are allocated as they
+ * fill), so there only the entity table is reserved.
+ */
+template<typename... Ts>
+class Prefab {
+public:
+  static_assert(sizeof...(Ts) > 0, "Prefab needs at least one component");
+
+  explicit Prefab(Ts... components) : components(std::move(components)...) {}
+
+  /*
+   * The component copied into each new instance, for changing the blueprint
+   * itself
+   */
+  template<typename T>
+  T& get() { return std::get<T>(components); }
+
+  /*
+   * Create one instance in the given scope and return it
+   */
+  EntityId spawn(EntityRegistry &registry, ScopeId scope = globalScope) {
+    EntityId entityId = registry.create(scope);
+    (registry.addComponent<Ts>(entityId, std::get<Ts>(components)), ...);
+    return entityId;
+  }
+
+  /*
+   * Create count instances in the given scope. configure(index, entity,
+   * Ts&...) is called for each on its copies of the components before they
+   * are added, to apply per-instance overrides, so onAdd observers and change
+   * tracking see the instance's values rather than the blueprint's.
+   */
+  template<typename Func>
+  void spawn(EntityRegistry &registry, std::size_t count, Func configure,
+             ScopeId scope = globalScope) {
+    registry.reserve<Ts...>(count);
+    for (std::size_t index = 0; index < count; index++) {
+      EntityId entityId = registry.create(scope);
+      std::tuple<Ts...> instance = components;
+      configure(index, entityId, std::get<Ts>(instance)...);
+      (registry.addComponent<Ts>(entityId, std::move(std::get<Ts>(instance))),
+       ...);
+    }
+  }
+
+  /*
+   * Create count identical instances, appending their IDs to out
+   */
+  void spawn(EntityRegistry &registry, std::size_t count,
+             std::vector<EntityId> &out, ScopeId scope = globalScope) {
+    out.reserve(out.size() + count);
+    spawn(registry, count,
+          [&out](std::size_t, EntityId entityId, Ts&...) {
+            out.push_back(entityId);
+          },
+          scope);
+  }
+
+private:
+  std::tuple<Ts...> components;
+};
@@ -0,0 +1,512 @@
+#pragma once
+
+#include "ECS.h"
+#include <algorithm>
+#include <array>
+#include <bit>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <fstream>
+#include <string>
+#include <tuple>
+#include <type_traits>
+#include <unordered_map>
+#include <unordered_set>
+#include <utility>
+#include <vector>
+
+//------------------------------------------------------------------------------
+// Binary streams
+//------------------------------------------------------------------------------
+
+/*
+ * Appends values to a byte buffer in the machine's native layout. Snapshots
+ * are meant for quick-saves and caches on the same build, not for exchange
+ * between platforms.
+ */
+class SnapshotWriter {
+public:
+  explicit SnapshotWriter(std::vector<std::byte> &buffer) : buffer(buffer) {}
+
+  template<typename T>
+  void write(const T &value) {
+    static_assert(std::is_trivially_copyable_v<T>,
+                  "Only trivially copyable values can be written directly");
+    writeBytes(&value, sizeof(T));
+  }
+
+  void writeBytes(const void *data, std::size_t size) {
+    const std::byte *bytes = static_cast<const std::byte*>(data);
+    buffer.insert(buffer.end(), bytes, bytes + size);
+  }
+
+  void writeString(const std::string &text) {
+    write(static_cast<std::uint32_t>(text.size()));
+    writeBytes(text.data(), text.size());
+  }
+
+private:
+  std::vector<std::byte> &buffer;
+};
+
+/*
+ * Reads values written by SnapshotWriter. Reading past the end (a truncated
+ * or corrupt snapshot) marks the reader as failed and yields zeroed values
+ * from then on, so hooks can read unconditionally and check ok() at the end.
+ */
+class SnapshotReader {
+public:
+  SnapshotReader(const std::byte *data, std::size_t size)
+      : data(data), size(size) {}
+
+  template<typename T>
+  T read() {
+    static_assert(std::is_trivially_copyable_v<T>,
+                  "Only trivially copyable values can be read directly");
+    std::array<std::byte, sizeof(T)> raw = {};
+    readBytes(raw.data(), sizeof(T));
+    return std::bit_cast<T>(raw);
+  }
+
+  bool readBytes(void *out, std::size_t count) {
+    if (failed || count > remaining()) {
+      failed = true;
+      std::memset(out, 0, count);
+      return false;
+    }
+    std::memcpy(out, data + offset, count);
+    offset += count;
+    return true;
+  }
+
+  std::string readString() {
+    std::uint32_t length = read<std::uint32_t>();
+    if (failed || length > remaining()) {
+      failed = true;
+      return {};
+    }
+    std::string text(reinterpret_cast<const char*>(data + offset), length);
+    offset += length;
+    return text;
+  }
+
+  /*
+   * The handle a saved entity was restored under. Handles to entities that
+   * weren't part of the snapshot (and every handle when a whole registry is
+   * restored) come back unchanged.
+   */
+  EntityId entity(EntityId saved) const {
+    if (!remap)
+      return saved;
+    auto found = remap->find(saved);
+    return found != remap->end() ? found->second : saved;
+  }
+
+  std::size_t remaining() const { return size - offset; }
+
+  // Hooks call fail() when they read something they can't use
+  void fail() { failed = true; }
+  bool ok() const { return !failed; }
+
+  void setRemap(const std::unordered_map<EntityId, EntityId> *table) {
+    remap = table;
+  }
+
+private:
+  const std::byte *data;
+  std::size_t size;
+  std::size_t offset = 0;
+  bool failed = false;
+  const std::unordered_map<EntityId, EntityId> *remap = nullptr;
+};
+
+//------------------------------------------------------------------------------
+// Component hooks
+//------------------------------------------------------------------------------
+
+/*
+ * How a component type is written to and read back from a snapshot.
+ * Trivially copyable components are copied byte for byte. Components that
+ * own resources (textures, sounds...) or heap data declare
+ *
+ *   void saveSnapshot(SnapshotWriter &out) const;
+ *   static T loadSnapshot(SnapshotReader &in);
+ *
+ * and save whatever they need to recreate those resources, such as the path
+ * they were loaded from. Types that can't be changed can specialise
+ * SnapshotTraits instead. A component loaded from a snapshot that turns out
+ * to be bad further on is never added to the registry; if it has a clean()
+ * it is called to release what loadSnapshot() acquired.
+ */
+template<typename T, typename = void>
+struct SnapshotTraits {
+  static_assert(std::is_trivially_copyable_v<T>,
+                "Give this component saveSnapshot() and loadSnapshot()");
+
+  // Size recorded in the header, so a snapshot from a build where the
+  // component's layout differs is rejected instead of misread
+  static constexpr std::uint32_t layout = sizeof(T);
+
+  static void save(SnapshotWriter &out, const T &component) {
+    out.write(component);
+  }
+
+  static T load(SnapshotReader &in) { return in.read<T>(); }
+};
+
+template<typename T>
+struct SnapshotTraits<T, std::void_t<decltype(&T::loadSnapshot)>> {
+  static constexpr std::uint32_t layout = 0;
+
+  static void save(SnapshotWriter &out, const T &component) {
+    component.saveSnapshot(out);
+  }
+
+  static T load(SnapshotReader &in) { return T::loadSnapshot(in); }
+};
+
+//------------------------------------------------------------------------------
+// Snapshot
+//------------------------------------------------------------------------------
+
+/*
+ * Binary copy of the entities in a registry and their components of the
+ * listed types. A snapshot is taken of either the whole registry or a single
+ * scope:
+ *
+ *   Snapshot<Transform, Sprite, Collider> quickSave;
+ *   quickSave.save(registry);            // every entity
+ *   ...
+ *   quickSave.restore(registry);         // replaces the registry's contents
+ *
+ * Restoring a whole registry brings every entity back under its saved handle,
+ * so handles held elsewhere (the player's, say) stay valid. Restoring a scope
+ * adds fresh entities to a scope of the registry and leaves everything else
+ * alone; hooks translate saved handles with SnapshotReader::entity().
+ *
+ * Components of types not listed are not saved. Observers see restored
+ * components being added just as if they were created by hand.
+ */
+template<typename... Components>
+class Snapshot {
+public:
+  static_assert(sizeof...(Components) > 0,
+                "Snapshot needs at least one component");
+  static_assert(sizeof...(Components) <= 255, "Too many component types");
+
+  Snapshot() = default;
+  explicit Snapshot(std::vector<std::byte> bytes) : buffer(std::move(bytes)) {}
+
+  /*
+   * Save every entity in the registry. The buffer is reused, so saving
+   * repeatedly doesn't reallocate once it has grown to size.
+   */
+  void save(EntityRegistry &registry) {
+    buffer.clear();
+    SnapshotWriter out(buffer);
+    writeHeader(out, Kind::Registry);
+
+    const std::vector<Entity> &records = registry.entityRecords();
+    out.write(static_cast<std::uint32_t>(records.size()));
+    for (const Entity &record : records) {
+      out.write(record.generation);
+      out.write(record.scope);
+      out.write(static_cast<std::uint8_t>(record.alive));
+    }
+
+    (saveComponents<Components>(registry, out, nullptr), ...);
+  }
+
+  /*
+   * Save only the entities in the given scope
+   */
+  void save(EntityRegistry &registry, ScopeId scope) {
+    buffer.clear();
+    SnapshotWriter out(buffer);
+    writeHeader(out, Kind::Scope);
+
+    const std::vector<EntityId> &members = registry.entitiesIn(scope);
+    out.write(static_cast<std::uint32_t>(members.size()));
+    out.writeBytes(members.data(), members.size() * sizeof(EntityId));
+
+    (saveComponents<Components>(registry, out, &members), ...);
+  }
+
+  /*
+   * Replace everything in the registry with a snapshot taken by
+   * save(registry). The whole snapshot is read and checked before the
+   * registry is touched: returns false, leaving the registry as it was, if
+   * the snapshot is malformed or was taken of a scope. Otherwise existing
+   * entities are destroyed (their onRemove observers run) and the saved ones
+   * added in their place.
+   */
+  bool restore(EntityRegistry &registry) const {
+    SnapshotReader in(buffer.data(), buffer.size());
+    if (!readHeader(in, Kind::Registry))
+      return false;
+
+    std::uint32_t slotCount = in.read<std::uint32_t>();
+    if (slotCount > maxEntities || slotCount > in.remaining() / 4)
+      return false;
+
+    std::vector<Entity> records(slotCount);
+    for (Entity &record : records) {
+      record.generation = in.read<std::uint16_t>();
+      record.scope = in.read<ScopeId>();
+      record.alive = in.read<std::uint8_t>() != 0;
+      if (record.generation == 0 || record.generation > entityGenerationMask)
+        return false;
+    }
+
+    auto saved = [&records](EntityId entityId) {
+      std::uint32_t index = entityIndex(entityId);
+      return index < records.size() && records[index].alive &&
+             records[index].generation == entityGeneration(entityId);
+    };
+    std::tuple<Loaded<Components>...> loaded;
+    if (!readAll(in, loaded, saved))
+      return false;
+
+    registry.restoreEntities(std::move(records));
+    (addComponents(registry, std::get<Loaded<Components>>(loaded)), ...);
+    return true;
+  }
+
+  /*
+   * Add the entities of a snapshot taken by save(registry, scope) to a scope
+   * (not necessarily the one saved). They get new handles. Returns false,
+   * adding nothing, if the snapshot is malformed or was taken of a whole
+   * registry.
+   */
+  bool restore(EntityRegistry &registry, ScopeId scope) const {
+    SnapshotReader in(buffer.data(), buffer.size());
+    if (!readHeader(in, Kind::Scope))
+      return false;
+
+    std::uint32_t count = in.read<std::uint32_t>();
+    if (count > in.remaining() / sizeof(EntityId))
+      return false;
+    std::vector<EntityId> saved(count);
+    in.readBytes(saved.data(), count * sizeof(EntityId));
+
+    // Hooks translate handles while they read, so the entities are created
+    // first. They stay bare until everything has been read.
+    std::unordered_map<EntityId, EntityId> remap;
+    remap.reserve(count);
+    registry.reserve<>(count);
+    for (EntityId entityId : saved)
+      remap[entityId] = registry.create(scope);
+    in.setRemap(&remap);
+
+    std::unordered_set<EntityId> created;
+    created.reserve(count);
+    for (auto [savedId, entityId] : remap)
+      created.insert(entityId);
+    auto restored = [&created](EntityId entityId) {
+      return created.contains(entityId);
+    };
+    std::tuple<Loaded<Components>...> loaded;
+    if (!readAll(in, loaded, restored)) {
+      for (auto [savedId, entityId] : remap)
+        registry.destroy(entityId);
+      return false;
+    }
+
+    (addComponents(registry, std::get<Loaded<Components>>(loaded)), ...);
+    return true;
+  }
+
+  const std::vector<std::byte>& bytes() const { return buffer; }
+  bool empty() const { return buffer.empty(); }
+  void clear() { buffer.clear(); }
+
+  /*
+   * Write the snapshot to a file, returning false if it can't be written
+   */
+  bool writeFile(const std::string &path) const {
+    std::ofstream file(path, std::ios::binary | std::ios::trunc);
+    file.write(reinterpret_cast<const char*>(buffer.data()),
+               static_cast<std::streamsize>(buffer.size()));
+    return file.good();
+  }
+
+  /*
+   * Load a snapshot written by writeFile(). Its contents are only checked
+   * when it is restored.
+   */
+  bool readFile(const std::string &path) {
+    std::ifstream file(path, std::ios::binary | std::ios::ate);
+    if (!file)
+      return false;
+    std::streamsize size = file.tellg();
+    file.seekg(0);
+    buffer.resize(static_cast<std::size_t>(size));
+    file.read(reinterpret_cast<char*>(buffer.data()), size);
+    if (!file) {
+      buffer.clear();
+      return false;
+    }
+    return true;
+  }
+
+private:
+  enum class Kind : std::uint8_t { Registry, Scope };
+
+  static constexpr std::uint32_t magic = 0x4e534750; // "PGSN"
+  static constexpr std::uint16_t formatVersion = 1;
+
+  std::vector<std::byte> buffer = {};
+
+  static void writeHeader(SnapshotWriter &out, Kind kind) {
+    out.write(magic);
+    out.write(formatVersion);
+    out.write(kind);
+    out.write(static_cast<std::uint8_t>(sizeof...(Components)));
+    (out.write(layoutOf<Components>()), ...);
+  }
+
+  static bool readHeader(SnapshotReader &in, Kind kind) {
+    bool matches = in.read<std::uint32_t>() == magic &&
+                   in.read<std::uint16_t>() == formatVersion &&
+                   in.read<Kind>() == kind &&
+                   in.read<std::uint8_t>() == sizeof...(Components);
+    matches = matches &&
+              ((in.read<std::uint32_t>() == layoutOf<Components>()) && ...);
+    return matches && in.ok();
+  }
+
+  template<typename T>
+  static constexpr std::uint32_t layoutOf() {
+    if constexpr (isTagComponent<T>)
+      return 0;
+    else
+      return SnapshotTraits<T>::layout;
+  }
+
+  /*
+   * Write the owners of every T (in the scope, if given) followed by the
+   * components themselves, so a reader can check the owners before decoding
+   * any component
+   */
+  template<typename T>
+  static void saveComponents(EntityRegistry &registry, SnapshotWriter &out,
+                             const std::vector<EntityId> *members) {
+    std::vector<std::pair<EntityId, T*>> owned;
+    if (members) {
+      for (EntityId entityId : *members) {
+        if (T *component = registry.tryGetComponent<T>(entityId))
+          owned.emplace_back(entityId, component);
+      }
+    } else if constexpr (isTagComponent<T>) {
+      // Views need at least one stored component, so look tags up in the
+      // entity table instead
+      const std::vector<Entity> &records = registry.entityRecords();
+      ComponentId cid = getComponentId<T>();
+      for (std::uint32_t index = 0; index < records.size(); index++) {
+        if (records[index].alive && records[index].componentBitset[cid])
+          owned.emplace_back(makeEntityId(index, records[index].generation),
+                             nullptr);
+      }
+    } else {
+      for (auto [entityId, component] : registry.view<T>())
+        owned.emplace_back(entityId, &component);
+    }
+
+    out.write(static_cast<std::uint32_t>(owned.size()));
+    for (auto &[entityId, component] : owned)
+      out.write(entityId);
+
+    if constexpr (!isTagComponent<T>) {
+      for (auto &[entityId, component] : owned)
+        SnapshotTraits<T>::save(out, *component);
+    }
+  }
+
+  // Components of one type read from a snapshot, not yet in a registry
+  template<typename T>
+  struct Loaded {
+    std::vector<EntityId> owners = {};
+    std::vector<T> components = {}; // empty for tags
+  };
+
+  /*
+   * Read every component type, or none: if one fails, the components already
+   * read are discarded and false is returned. owned(entity) says whether a
+   * (translated) owner handle belongs to the snapshot.
+   */
+  template<typename Owned>
+  static bool readAll(SnapshotReader &in,
+                      std::tuple<Loaded<Components>...> &loaded,
+                      const Owned &owned) {
+    bool ok = std::apply(
+        [&](Loaded<Components> &...parts) {
+          return (readComponents(in, parts, owned) && ...);
+        },
+        loaded);
+    if (!ok) {
+      std::apply([](Loaded<Components> &...parts) { (discard(parts), ...); },
+                 loaded);
+    }
+    return ok;
+  }
+
+  template<typename T, typename Owned>
+  static bool readComponents(SnapshotReader &in, Loaded<T> &loaded,
+                             const Owned &owned) {
+    std::uint32_t count = in.read<std::uint32_t>();
+    if (!in.ok() || count > in.remaining() / sizeof(EntityId))
+      return false;
+    if (storagePolicyOf<T> == StoragePolicy::Singleton && count > 1)
+      return false;
+    std::vector<EntityId> &owners = loaded.owners;
+    owners.resize(count);
+    in.readBytes(owners.data(), count * sizeof(EntityId));
+
+    for (EntityId &owner : owners) {
+      owner = in.entity(owner);
+      if (!owned(owner))
+        return false;
+    }
+    std::vector<EntityId> sorted = owners;
+    std::sort(sorted.begin(), sorted.end());
+    if (std::adjacent_find(sorted.begin(), sorted.end()) != sorted.end())
+      return false;
+
+    if constexpr (!isTagComponent<T>) {
+      loaded.components.reserve(count);
+      for (std::uint32_t index = 0; index < count; index++) {
+        loaded.components.push_back(SnapshotTraits<T>::load(in));
+        if (!in.ok())
+          return false;
+      }
+    }
+    return in.ok();
+  }
+
+  /*
+   * Release what components read from a bad snapshot hold. Components that
+   * own resources free them in clean(), which is otherwise left to onRemove
+   * observers.
+   */
+  template<typename T>
+  static void discard(Loaded<T> &loaded) {
+    if constexpr (requires(T &component) { component.clean(); }) {
+      for (T &component : loaded.components)
+        component.clean();
+    }
+    loaded.components.clear();
+  }
+
+  template<typename T>
+  static void addComponents(EntityRegistry &registry, Loaded<T> &loaded) {
+    registry.reserve<T>(loaded.owners.size());
+    for (std::size_t index = 0; index < loaded.owners.size(); index++) {
+      if constexpr (isTagComponent<T>)
+        registry.addComponent<T>(loaded.owners[index]);
+      else
+        registry.addComponent<T>(loaded.owners[index],
+                                 std::move(loaded.components[index]));
+    }
+  }
+};
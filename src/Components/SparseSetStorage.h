@@ -0,0 +1,684 @@
+#pragma once
+
+#include "Entity.h"
+#include "PagedPool.h"
+#include "StoragePolicy.h"
+#include "../Systems/ThreadPool.h"
+#include <array>
+#include <cassert>
+#include <limits>
+#include <memory>
+#include <optional>
+#include <tuple>
+#include <type_traits>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+//------------------------------------------------------------------------------
+// Sparse set
+//------------------------------------------------------------------------------
+
+/*
+ * Maps entity IDs to indices in a packed (dense) array. The sparse index is
+ * split into fixed-size pages that are only allocated once an entity in their
+ * range is added, so a lookup is two array reads and never hashes.
+ */
+class SparseSet {
+public:
+  static constexpr std::size_t pageSize = 4096;
+  static constexpr std::size_t nullIndex =
+      std::numeric_limits<std::size_t>::max();
+
+  virtual ~SparseSet() = default;
+
+  /*
+   * Return the packed index of the entity, or nullIndex if it is not present.
+   * Pages are indexed by the entity's slot, so a stale handle to a reused slot
+   * is rejected by comparing against the stored handle.
+   */
+  std::size_t indexOf(EntityId entityId) const {
+    std::size_t slot = entityIndex(entityId);
+    std::size_t page = slot / pageSize;
+    if (page >= sparse.size() || !sparse[page])
+      return nullIndex;
+
+    std::size_t index = (*sparse[page])[slot % pageSize];
+    if (index == nullIndex || dense[index] != entityId)
+      return nullIndex;
+    return index;
+  }
+
+  bool contains(EntityId entityId) const {
+    return indexOf(entityId) != nullIndex;
+  }
+
+  std::size_t size() const { return dense.size(); }
+  bool empty() const { return dense.empty(); }
+
+  // Make room for count more entities in the packed array
+  void reserve(std::size_t count) { dense.reserve(dense.size() + count); }
+
+  // Packed entity IDs, in the same order as any data stored alongside them
+  const std::vector<EntityId>& entities() const { return dense; }
+
+protected:
+  /*
+   * Append entity to the packed array and return its index
+   */
+  std::size_t insert(EntityId entityId) {
+    assert(!contains(entityId) && "Entity already in sparse set!");
+    std::size_t index = dense.size();
+    dense.push_back(entityId);
+    sparseSlot(entityId) = index;
+    return index;
+  }
+
+  /*
+   * Remove entity by moving the last packed entity into its place. Derived
+   * classes must apply the same swap to their own packed data first.
+   */
+  void swapAndPop(EntityId entityId) {
+    std::size_t index = indexOf(entityId);
+    EntityId lastEntityId = dense.back();
+
+    dense[index] = lastEntityId;
+    sparseSlot(lastEntityId) = index;
+
+    dense.pop_back();
+    sparseSlot(entityId) = nullIndex;
+  }
+
+  void reset() {
+    dense.clear();
+    sparse.clear();
+  }
+
+private:
+  using Page = std::array<std::size_t, pageSize>;
+
+  std::vector<EntityId> dense = {};
+  std::vector<std::unique_ptr<Page>> sparse = {};
+
+  std::size_t& sparseSlot(EntityId entityId) {
+    std::size_t slot = entityIndex(entityId);
+    std::size_t page = slot / pageSize;
+    if (page >= sparse.size())
+      sparse.resize(page + 1);
+    if (!sparse[page]) {
+      sparse[page] = std::make_unique<Page>();
+      sparse[page]->fill(nullIndex);
+    }
+    return (*sparse[page])[slot % pageSize];
+  }
+};
+
+//------------------------------------------------------------------------------
+// Component arrays
+//------------------------------------------------------------------------------
+
+/*
+ * Every component array has the same interface: addComponent, getComponent,
+ * removeComponent, clear and reserve, and all but tag arrays also have
+ * contains, size and entities (the entities holding a component, which views
+ * iterate). Only removal is virtual, for destroying entities whose component
+ * types are only known from their signatures.
+ */
+class IComponentArray {
+public:
+    virtual ~IComponentArray() = default;
+    virtual void removeComponent(EntityId entityId) = 0;
+
+    // Remove the components of every entity in batch, if they have one
+    virtual void removeEntities(const SparseSet &batch) = 0;
+};
+
+/*
+ * Shared removeEntities() for arrays with an entity list. Costs
+ * O(min(batch, array)) lookups: a small batch is removed entity by entity,
+ * otherwise the array is walked instead, and cleared outright if the batch
+ * holds all of it.
+ */
+template<typename Array>
+void removeEntitiesFrom(Array &array, const SparseSet &batch) {
+  if (batch.size() < array.size()) {
+    for (EntityId entityId : batch.entities())
+      array.removeComponent(entityId);
+    return;
+  }
+
+  const std::vector<EntityId> &entities = array.entities();
+  bool all = true;
+  for (EntityId entityId : entities) {
+    if (!batch.contains(entityId)) {
+      all = false;
+      break;
+    }
+  }
+  if (all) {
+    array.clear();
+    return;
+  }
+
+  // Walk backwards, so the entity swapped into a removed slot has already
+  // been checked
+  for (std::size_t index = entities.size(); index-- > 0;) {
+    if (batch.contains(entities[index]))
+      array.removeComponent(entities[index]);
+  }
+}
+
+/*
+ * Dense storage. Components live in a paged pool, so they never move once
+ * created: adding more components never relocates existing ones, and removing
+ * one only reorders the pointers. The pointers are packed in the same order
+ * as the sparse set's dense entity array, so index i of one corresponds to
+ * index i of the other.
+ */
+template<typename T>
+class ComponentArray final : public IComponentArray, public SparseSet {
+public:
+  ComponentArray() = default;
+  ComponentArray(const ComponentArray &) = delete;
+  ComponentArray& operator=(const ComponentArray &) = delete;
+
+  ~ComponentArray() override {
+    for (T *component : components)
+      pool.destroy(component);
+  }
+
+  template<typename... TArgs>
+  T& addComponent(EntityId entityId, TArgs&&... mArgs) {
+    T *component = pool.create(std::forward<TArgs>(mArgs)...);
+    insert(entityId);
+    components.push_back(component);
+    return *component;
+  }
+
+  T& getComponent(EntityId entityId) {
+    std::size_t index = indexOf(entityId);
+    assert(index != nullIndex && "Component not found!");
+    return *components[index];
+  }
+
+  void removeComponent(EntityId entityId) override {
+    std::size_t index = indexOf(entityId);
+    if (index == nullIndex) {
+        return;
+    }
+
+    pool.destroy(components[index]);
+    components[index] = components.back();
+    components.pop_back();
+    swapAndPop(entityId);
+  }
+
+  void removeEntities(const SparseSet &batch) override {
+    removeEntitiesFrom(*this, batch);
+  }
+
+  /*
+   * Destroy every component, keeping the pool's pages for reuse
+   */
+  void clear() {
+    for (T *component : components)
+      pool.destroy(component);
+    components.clear();
+    reset();
+  }
+
+  /*
+   * Make room for count more components without allocating
+   */
+  void reserve(std::size_t count) {
+    SparseSet::reserve(count);
+    components.reserve(components.size() + count);
+    pool.reserve(count);
+  }
+
+  // Pointers to the components, ordered as entities()
+  const std::vector<T*>& data() const { return components; }
+
+private:
+    PagedPool<T> pool;
+    std::vector<T*> components = {};
+};
+
+/*
+ * Sparse storage, for types few entities have. Components are nodes of a hash
+ * map keyed by entity, so they never move, and there are no sparse set pages
+ * sized for every entity slot. Each entry remembers its position in the
+ * packed entity list so removal can swap and pop.
+ */
+template<typename T>
+class SparseComponentArray final : public IComponentArray {
+public:
+  SparseComponentArray() = default;
+  SparseComponentArray(const SparseComponentArray &) = delete;
+  SparseComponentArray& operator=(const SparseComponentArray &) = delete;
+
+  template<typename... TArgs>
+  T& addComponent(EntityId entityId, TArgs&&... mArgs) {
+    auto [entry, inserted] = components.try_emplace(
+        entityId, dense.size(), std::forward<TArgs>(mArgs)...);
+    assert(inserted && "Entity already has this component!");
+    dense.push_back(entityId);
+    return entry->second.component;
+  }
+
+  T& getComponent(EntityId entityId) {
+    auto entry = components.find(entityId);
+    assert(entry != components.end() && "Component not found!");
+    return entry->second.component;
+  }
+
+  void removeComponent(EntityId entityId) override {
+    auto entry = components.find(entityId);
+    if (entry == components.end())
+      return;
+
+    std::size_t index = entry->second.index;
+    EntityId lastEntityId = dense.back();
+    dense[index] = lastEntityId;
+    dense.pop_back();
+    if (lastEntityId != entityId)
+      components.find(lastEntityId)->second.index = index;
+    components.erase(entry);
+  }
+
+  void removeEntities(const SparseSet &batch) override {
+    removeEntitiesFrom(*this, batch);
+  }
+
+  bool contains(EntityId entityId) const {
+    return components.find(entityId) != components.end();
+  }
+
+  std::size_t size() const { return dense.size(); }
+  bool empty() const { return dense.empty(); }
+  const std::vector<EntityId>& entities() const { return dense; }
+
+  void clear() {
+    components.clear();
+    dense.clear();
+  }
+
+  void reserve(std::size_t count) {
+    components.reserve(components.size() + count);
+    dense.reserve(dense.size() + count);
+  }
+
+private:
+  struct Entry {
+    std::size_t index; // position in dense
+    T component;
+
+    template<typename... TArgs>
+    explicit Entry(std::size_t index, TArgs&&... mArgs)
+        : index(index), component(std::forward<TArgs>(mArgs)...) {}
+  };
+
+  std::unordered_map<EntityId, Entry> components = {};
+  std::vector<EntityId> dense = {};
+};
+
+/*
+ * Singleton storage, for types at most one entity has at a time. The
+ * component sits in a single slot and a lookup is one compare.
+ */
+template<typename T>
+class SingletonComponentArray final : public IComponentArray {
+public:
+  SingletonComponentArray() { owner.reserve(1); }
+  SingletonComponentArray(const SingletonComponentArray &) = delete;
+  SingletonComponentArray& operator=(const SingletonComponentArray &) = delete;
+
+  // Enforces the single owner; reserve() can't, as bulk paths call it before
+  // they know how many entities will really get the component
+  template<typename... TArgs>
+  T& addComponent(EntityId entityId, TArgs&&... mArgs) {
+    assert(owner.empty() &&
+           "Singleton component already belongs to an entity!");
+    T &component = slot.emplace(std::forward<TArgs>(mArgs)...);
+    owner.push_back(entityId);
+    return component;
+  }
+
+  T& getComponent(EntityId entityId) {
+    assert(contains(entityId) && "Component not found!");
+    return *slot;
+  }
+
+  void removeComponent(EntityId entityId) override {
+    if (!contains(entityId))
+      return;
+    slot.reset();
+    owner.clear();
+  }
+
+  void removeEntities(const SparseSet &batch) override {
+    if (!owner.empty() && batch.contains(owner.front()))
+      clear();
+  }
+
+  bool contains(EntityId entityId) const {
+    return !owner.empty() && owner.front() == entityId;
+  }
+
+  std::size_t size() const { return owner.size(); }
+  bool empty() const { return owner.empty(); }
+
+  // Holds the owning entity, if there is one
+  const std::vector<EntityId>& entities() const { return owner; }
+
+  void clear() {
+    slot.reset();
+    owner.clear();
+  }
+
+  void reserve(std::size_t) {}
+
+private:
+  std::optional<T> slot = std::nullopt;
+  std::vector<EntityId> owner = {};
+};
+
+/*
+ * Tag storage. Whether an entity has a tag is recorded only in its signature,
+ * so there is nothing to store: every entity shares one empty instance.
+ */
+template<typename T>
+class TagComponentArray final : public IComponentArray {
+public:
+  static_assert(std::is_empty_v<T>, "Only empty types can be tags");
+
+  template<typename... TArgs>
+  T& addComponent(EntityId, TArgs&&...) { return instance; }
+
+  T& getComponent(EntityId) { return instance; }
+
+  void removeComponent(EntityId) override {}
+  void removeEntities(const SparseSet &) override {}
+
+  void clear() {}
+  void reserve(std::size_t) {}
+
+private:
+  static inline T instance = {};
+};
+
+/*
+ * Component array type used for T under its storage policy
+ */
+template<typename T>
+using ComponentArrayFor = std::conditional_t<
+    storagePolicyOf<T> == StoragePolicy::Tag, TagComponentArray<T>,
+    std::conditional_t<
+        storagePolicyOf<T> == StoragePolicy::Singleton,
+        SingletonComponentArray<T>,
+        std::conditional_t<storagePolicyOf<T> == StoragePolicy::Sparse,
+                           SparseComponentArray<T>, ComponentArray<T>>>>;
+
+/*
+ * Point candidates at the entity list of array if it is smaller than the
+ * current one. Tag arrays have no entity list and are skipped.
+ */
+template<typename T>
+void pickSmallerEntityList(const std::vector<EntityId> *&candidates,
+                           ComponentArrayFor<T> &array) {
+  if constexpr (!isTagComponent<T>) {
+    if (!candidates || array.size() < candidates->size())
+      candidates = &array.entities();
+  }
+}
+
+//------------------------------------------------------------------------------
+// Views
+//------------------------------------------------------------------------------
+
+/*
+ * Non-owning view over the entities that hold every component in Ts. It walks
+ * a list of candidate entities (the packed entities of the smallest component
+ * array, or a group) and filters them by signature, so iterating never
+ * allocates. Tags have no entity list of their own and only filter.
+ * Iteration yields (entity, Ts&...) tuples:
+ *
+ *   for (auto [entity, transform, sprite] : registry.view<Transform, Sprite>())
+ *
+ * Adding or removing components of the viewed types while iterating may skip
+ * or revisit entities.
+ */
+template<typename... Ts>
+class View {
+public:
+  using value_type = std::tuple<EntityId, Ts&...>;
+
+  class Iterator {
+  public:
+    Iterator(const View *view, std::size_t index) : view(view), index(index) {
+      skipUnmatched();
+    }
+
+    value_type operator*() const {
+      return view->get((*view->candidates)[index]);
+    }
+
+    Iterator& operator++() {
+      ++index;
+      skipUnmatched();
+      return *this;
+    }
+
+    bool operator==(const Iterator &other) const {
+      return index == other.index;
+    }
+
+  private:
+    const View *view;
+    std::size_t index;
+
+    void skipUnmatched() {
+      while (index < view->candidateCount() &&
+             !view->matches((*view->candidates)[index]))
+        ++index;
+    }
+  };
+
+  // Empty view, used when one of the component arrays doesn't exist yet
+  View() = default;
+
+  View(const std::vector<EntityId> *candidates,
+       const std::vector<Entity> *entities, Signature mask,
+       ComponentArrayFor<Ts>*... arrays)
+      : candidates(candidates), entities(entities), mask(mask),
+        arrays(arrays...) {}
+
+  Iterator begin() const { return Iterator(this, 0); }
+  Iterator end() const { return Iterator(this, candidateCount()); }
+
+  /*
+   * Call func(entity, Ts&...) for every matching entity
+   */
+  template<typename Func>
+  void each(Func func) const {
+    for (std::size_t index = 0; index < candidateCount(); index++) {
+      EntityId entityId = (*candidates)[index];
+      if (matches(entityId))
+        func(entityId, std::get<ComponentArrayFor<Ts>*>(arrays)
+                           ->getComponent(entityId)...);
+    }
+  }
+
+  /*
+   * Like each(), but splits the entities into chunks run in parallel on the
+   * shared thread pool. The result is deterministic as long as func only
+   * writes to the components it is given; func must not add or remove
+   * components or entities.
+   */
+  template<typename Func>
+  void parallelEach(Func func) const {
+    parallelEach(ThreadPool::shared(), func);
+  }
+
+  template<typename Func>
+  void parallelEach(ThreadPool &pool, Func func) const {
+    // Only the candidate list is walked in order; components are reached
+    // through entity lookups, so where they sit in memory is unknown here
+    std::size_t count = candidateCount();
+    pool.parallelFor(count, pool.chunkSizeFor<EntityId>(count),
+      [&](std::size_t begin, std::size_t end) {
+        for (std::size_t index = begin; index < end; index++) {
+          EntityId entityId = (*candidates)[index];
+          if (matches(entityId))
+            func(entityId, std::get<ComponentArrayFor<Ts>*>(arrays)
+                               ->getComponent(entityId)...);
+        }
+      });
+  }
+
+  // Upper bound on the number of entities the view yields
+  std::size_t sizeHint() const { return candidateCount(); }
+
+private:
+  const std::vector<EntityId> *candidates = nullptr;
+  const std::vector<Entity> *entities = nullptr;
+  Signature mask = 0;
+  std::tuple<ComponentArrayFor<Ts>*...> arrays = {};
+
+  std::size_t candidateCount() const {
+    return candidates ? candidates->size() : 0;
+  }
+
+  bool matches(EntityId entityId) const {
+    return ((*entities)[entityIndex(entityId)].componentBitset & mask) == mask;
+  }
+
+  value_type get(EntityId entityId) const {
+    return value_type(entityId,
+        std::get<ComponentArrayFor<Ts>*>(arrays)->getComponent(entityId)...);
+  }
+};
+
+//------------------------------------------------------------------------------
+// Storage
+//------------------------------------------------------------------------------
+
+/*
+ * Component storage with one packed sparse-set array per component type.
+ * Adding or removing a component only touches that type's array, and views
+ * join arrays by looking entities up in the others.
+ */
+class SparseSetStorage {
+public:
+  template<typename T, typename... TArgs>
+  T& add(EntityId entityId, TArgs&&... mArgs) {
+    return assureComponentArray<T>()->addComponent(
+        entityId, std::forward<TArgs>(mArgs)...);
+  }
+
+  template<typename T>
+  void remove(EntityId entityId) {
+    getComponentArray<T>()->removeComponent(entityId);
+  }
+
+  template<typename T>
+  T& get(EntityId entityId) {
+    return getComponentArray<T>()->getComponent(entityId);
+  }
+
+  /*
+   * Remove all components named in the entity's signature
+   */
+  void destroy(EntityId entityId, const Signature &signature) {
+    for (std::size_t cid = 0; cid < componentArrays.size(); cid++) {
+      if (signature[cid])
+        componentArrays[cid]->removeComponent(entityId);
+    }
+  }
+
+  /*
+   * Remove all components of the entities in batch, which between them hold
+   * the component types in signature. Each array is visited once, rather
+   * than once per entity.
+   */
+  void destroyAll(const SparseSet &batch, const Signature &signature) {
+    for (std::size_t cid = 0; cid < componentArrays.size(); cid++) {
+      if (signature[cid])
+        componentArrays[cid]->removeEntities(batch);
+    }
+  }
+
+  void clear() { componentArrays.clear(); }
+
+  /*
+   * Make room for count more components of type T without allocating
+   */
+  template<typename T>
+  void reserve(std::size_t count) {
+    assureComponentArray<T>()->reserve(count);
+  }
+
+  /*
+   * View over all entities with every component in Ts, driven by the smallest
+   * of the component arrays involved
+   */
+  template<typename... Ts>
+  View<Ts...> view(const std::vector<Entity> &entities) {
+    static_assert(!(isTagComponent<Ts> && ...),
+                  "Tags have no entity list to iterate, use group() instead");
+    std::tuple<ComponentArrayFor<Ts>*...> arrays(getComponentArray<Ts>()...);
+
+    // No entity can match if a component type has never been added
+    if (((std::get<ComponentArrayFor<Ts>*>(arrays) == nullptr) || ...))
+      return View<Ts...>();
+
+    // Pick the smallest array to drive iteration
+    const std::vector<EntityId> *candidates = nullptr;
+    (pickSmallerEntityList<Ts>(candidates,
+                               *std::get<ComponentArrayFor<Ts>*>(arrays)),
+     ...);
+
+    return View<Ts...>(candidates, &entities, makeSignature<Ts...>(),
+                       std::get<ComponentArrayFor<Ts>*>(arrays)...);
+  }
+
+  /*
+   * View over a list of entities that are known to have every component in Ts
+   */
+  template<typename... Ts>
+  View<Ts...> view(const std::vector<EntityId> &candidates,
+                   const std::vector<Entity> &entities) {
+    return View<Ts...>(&candidates, &entities, makeSignature<Ts...>(),
+                       assureComponentArray<Ts>()...);
+  }
+
+private:
+  // Indexed directly by component ID
+  std::vector<std::unique_ptr<IComponentArray>> componentArrays = {};
+
+  /*
+   * Return the component array for type T, or a null pointer if no component
+   * of this type has been added yet
+   */
+  template<typename T>
+  ComponentArrayFor<T>* getComponentArray() {
+    ComponentId cid = getComponentId<T>();
+    if (cid >= componentArrays.size())
+      return nullptr;
+    return static_cast<ComponentArrayFor<T>*>(componentArrays[cid].get());
+  }
+
+  /*
+   * Return the component array for type T, creating it if it doesn't exist
+   */
+  template<typename T>
+  ComponentArrayFor<T>* assureComponentArray() {
+    ComponentId cid = getComponentId<T>();
+    assert(cid < maxComponents && "Too many component types!");
+    if (cid >= componentArrays.size())
+      componentArrays.resize(cid + 1);
+    if (!componentArrays[cid])
+      componentArrays[cid] = std::make_unique<ComponentArrayFor<T>>();
+    return static_cast<ComponentArrayFor<T>*>(componentArrays[cid].get());
+  }
+};
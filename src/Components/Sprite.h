@@ -3,11 +3,14 @@
 #include "../Camera.h"
 #include "../TextureManager.h"
 #include "Animation.h"
+#include "Snapshot.h"
 #include "SDL3/SDL_rect.h"
 #include "SDL3/SDL_render.h"
 #include "SDL3/SDL_surface.h"
 #include "SDL3/SDL_timer.h"
 #include "Transform.h"
+#include <string>
+#include <utility>
 #include <vector>
 
 class Sprite {
@@ -33,10 +36,63 @@ public:
     this->width = width;
     this->height = height;
 
-    texture = TextureManager::LoadTexture(texturePath);
+    image = Image(texturePath);
     animations = anims;
   }
 
+  /*
+   * Snapshot hooks. The texture is saved as the path it was loaded from and
+   * found in the atlas or texture cache on restore; the frame is worked out
+   * again by update().
+   */
+  void saveSnapshot(SnapshotWriter &out) const {
+    out.writeString(image.path);
+    out.write(width);
+    out.write(height);
+    out.write(posOffset);
+    out.write(drawOrderId);
+    out.write(spriteFlip);
+
+    out.write(static_cast<std::uint32_t>(animations.size()));
+    for (const Animation &animation : animations) {
+      out.writeString(animation.name);
+      out.write(animation.index);
+      out.write(animation.frames);
+      out.write(animation.speed);
+    }
+    out.write(animIdx);
+    out.write(static_cast<std::uint8_t>(animated));
+  }
+
+  static Sprite loadSnapshot(SnapshotReader &in) {
+    std::string path = in.readString();
+    float width = in.read<float>();
+    float height = in.read<float>();
+    Offset posOffset = in.read<Offset>();
+    int drawOrderId = in.read<int>();
+    SDL_FlipMode flip = in.read<SDL_FlipMode>();
+
+    std::vector<Animation> anims;
+    std::uint32_t count = in.read<std::uint32_t>();
+    for (std::uint32_t i = 0; i < count && in.ok(); i++) {
+      std::string name = in.readString();
+      int index = in.read<int>();
+      int frames = in.read<int>();
+      int speed = in.read<int>();
+      anims.emplace_back(name, index, frames, speed);
+    }
+    int animIdx = in.read<int>();
+    bool animated = in.read<std::uint8_t>() != 0;
+    if (animIdx < 0 || (!anims.empty() && animIdx >= int(anims.size())))
+      in.fail();
+
+    Sprite sprite(path.c_str(), width, height, posOffset, anims, drawOrderId);
+    sprite.spriteFlip = flip;
+    sprite.animIdx = in.ok() ? animIdx : 0;
+    sprite.animated = sprite.animStart = sprite.animUnfinished = animated;
+    return sprite;
+  }
+
   void update(Transform &transform) {
     if ((animated || animUnfinished) && !animations.empty()) {
       // If we just started this animation, calculate an
@@ -80,7 +136,10 @@ public:
   }
 
   void render() {
-    TextureManager::Draw(texture, srcRect, destRect, spriteFlip);
+    SDL_FRect atlasRect = srcRect;
+    atlasRect.x += image.atlasOrigin.x;
+    atlasRect.y += image.atlasOrigin.y;
+    TextureManager::Draw(image.texture, atlasRect, destRect, spriteFlip);
   }
 
   void play(const std::string animName) {
@@ -98,10 +157,78 @@ public:
     animStart = 0;
   }
 
-  void clean() { SDL_DestroyTexture(texture); }
+  void clean() { image.release(); }
 
 private:
-  SDL_Texture *texture;
+  /*
+   * The texture a sprite draws from: its own image from the texture cache, or
+   * a region of an atlas page. Copies of a cached image take a reference of
+   * their own, so each copy of a Sprite (the instances a Prefab<Sprite>
+   * spawns, say) is cleaned once; moves hand the reference over. As with
+   * other components, the reference is released by clean(), not on
+   * destruction.
+   */
+  struct Image {
+    std::string path;
+    SDL_Texture *texture = nullptr;
+
+    // Top left of the image within its atlas page, if it has been packed
+    SDL_FPoint atlasOrigin = {0, 0};
+
+    // Holds a reference on a cached texture rather than using an atlas page
+    bool cached = true;
+
+    Image() = default;
+
+    explicit Image(const char *imagePath) : path(imagePath) {
+      // Images packed into the map's atlas share its page texture
+      if (const AtlasRegion *region = TextureManager::GetAtlasRegion(path)) {
+        texture = region->page;
+        atlasOrigin = {region->rect.x, region->rect.y};
+        cached = false;
+      } else {
+        texture = TextureManager::AcquireTexture(path);
+      }
+    }
+
+    Image(const Image &other)
+        : path(other.path), texture(other.texture),
+          atlasOrigin(other.atlasOrigin), cached(other.cached) {
+      if (cached && texture)
+        texture = TextureManager::AcquireTexture(path);
+    }
+
+    Image(Image &&other) noexcept
+        : path(std::move(other.path)),
+          texture(std::exchange(other.texture, nullptr)),
+          atlasOrigin(other.atlasOrigin), cached(other.cached) {}
+
+    Image &operator=(const Image &other) {
+      if (this != &other)
+        *this = Image(other);
+      return *this;
+    }
+
+    Image &operator=(Image &&other) noexcept {
+      if (this != &other) {
+        release();
+        path = std::move(other.path);
+        texture = std::exchange(other.texture, nullptr);
+        atlasOrigin = other.atlasOrigin;
+        cached = other.cached;
+      }
+      return *this;
+    }
+
+    // Atlas pages are released with the atlas
+    void release() {
+      if (cached)
+        TextureManager::ReleaseTexture(texture);
+      texture = nullptr;
+    }
+  };
+
+  Image image;
   SDL_FRect srcRect, destRect;
 
   bool animated = false;
@@ -0,0 +1,288 @@
+#pragma once
+
+#include "Entity.h"
+#include "SparseSetStorage.h"
+#include "../Systems/ThreadPool.h"
+#include <bitset>
+#include <cassert>
+#include <cstddef>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+
+//------------------------------------------------------------------------------
+// Compile-time component lists
+//------------------------------------------------------------------------------
+
+/*
+ * Position of T in Ts, or sizeof...(Ts) if T is not in the list
+ */
+template<typename T, typename... Ts>
+constexpr std::size_t typeIndex() {
+  constexpr bool matches[] = {std::is_same_v<T, Ts>...};
+  for (std::size_t i = 0; i < sizeof...(Ts); i++) {
+    if (matches[i])
+      return i;
+  }
+  return sizeof...(Ts);
+}
+
+template<typename... Ts, std::size_t... Is>
+constexpr bool uniqueTypes(std::index_sequence<Is...>) {
+  return ((typeIndex<Ts, Ts...>() == Is) && ...);
+}
+
+/*
+ * True if no type appears twice in Ts
+ */
+template<typename... Ts>
+constexpr bool uniqueTypes() {
+  return uniqueTypes<Ts...>(std::index_sequence_for<Ts...>());
+}
+
+//------------------------------------------------------------------------------
+// Views
+//------------------------------------------------------------------------------
+
+/*
+ * View over the entities of a Registry that hold every component in Ts. Works
+ * like View: the smallest pool drives iteration and candidates are filtered
+ * by a single masked compare against their signature.
+ */
+template<typename RegistryT, typename... Ts>
+class StaticView {
+public:
+  using value_type = std::tuple<EntityId, Ts&...>;
+
+  class Iterator {
+  public:
+    Iterator(const StaticView *view, std::size_t index)
+        : view(view), index(index) {
+      skipUnmatched();
+    }
+
+    value_type operator*() const {
+      return view->get((*view->candidates)[index]);
+    }
+
+    Iterator& operator++() {
+      ++index;
+      skipUnmatched();
+      return *this;
+    }
+
+    bool operator==(const Iterator &other) const {
+      return index == other.index;
+    }
+
+  private:
+    const StaticView *view;
+    std::size_t index;
+
+    void skipUnmatched() {
+      while (index < view->candidates->size() &&
+             !view->matches((*view->candidates)[index]))
+        ++index;
+    }
+  };
+
+  explicit StaticView(RegistryT *registry) : registry(registry) {
+    static_assert(!(isTagComponent<Ts> && ...),
+                  "Tags have no entity list to iterate");
+
+    // Pick the smallest pool to drive iteration
+    (pickSmallerEntityList<Ts>(candidates, registry->template pool<Ts>()), ...);
+  }
+
+  Iterator begin() const { return Iterator(this, 0); }
+  Iterator end() const { return Iterator(this, candidates->size()); }
+
+  /*
+   * Call func(entity, Ts&...) for every matching entity
+   */
+  template<typename Func>
+  void each(Func func) const {
+    for (EntityId entityId : *candidates) {
+      if (matches(entityId))
+        func(entityId, registry->template pool<Ts>().getComponent(entityId)...);
+    }
+  }
+
+  /*
+   * Like each(), but splits the entities into chunks run in parallel on the
+   * shared thread pool. The result is deterministic as long as func only
+   * writes to the components it is given; func must not add or remove
+   * components or entities.
+   */
+  template<typename Func>
+  void parallelEach(Func func) const {
+    parallelEach(ThreadPool::shared(), func);
+  }
+
+  template<typename Func>
+  void parallelEach(ThreadPool &pool, Func func) const {
+    // Only the candidate list is walked in order; components are reached
+    // through entity lookups, so where they sit in memory is unknown here
+    std::size_t count = candidates->size();
+    pool.parallelFor(count, pool.chunkSizeFor<EntityId>(count),
+      [&](std::size_t begin, std::size_t end) {
+        for (std::size_t index = begin; index < end; index++) {
+          EntityId entityId = (*candidates)[index];
+          if (matches(entityId))
+            func(entityId, registry->template pool<Ts>().getComponent(entityId)...);
+        }
+      });
+  }
+
+  // Upper bound on the number of entities the view yields
+  std::size_t sizeHint() const { return candidates->size(); }
+
+private:
+  RegistryT *registry;
+  const std::vector<EntityId> *candidates = nullptr;
+
+  bool matches(EntityId entityId) const {
+    return registry->template hasComponents<Ts...>(entityId);
+  }
+
+  value_type get(EntityId entityId) const {
+    return value_type(entityId,
+                      registry->template pool<Ts>().getComponent(entityId)...);
+  }
+};
+
+//------------------------------------------------------------------------------
+// Registry
+//------------------------------------------------------------------------------
+
+/*
+ * Entity registry whose component types are fixed at compile time:
+ *
+ *   Registry<Transform, Sprite, Collider> registry;
+ *
+ * Component IDs are the types' positions in the list and are constexpr, the
+ * signature is exactly as wide as the list (so there is no component cap),
+ * and the pools live in a std::tuple, so reaching a component's pool needs no
+ * lookup or virtual call. Each pool follows its type's StoragePolicy. The API
+ * mirrors EntityRegistry.
+ */
+template<typename... Components>
+class Registry {
+public:
+  static_assert(sizeof...(Components) > 0, "Registry needs at least one component");
+  static_assert(uniqueTypes<Components...>(), "Component types must be unique");
+
+  static constexpr std::size_t componentCount = sizeof...(Components);
+  using Signature = std::bitset<componentCount>;
+  using Record = BasicEntity<Signature>;
+
+  template<typename T>
+  static constexpr std::size_t componentId = [] {
+    constexpr std::size_t id = typeIndex<T, Components...>();
+    static_assert(id < componentCount, "Component is not in this registry");
+    return id;
+  }();
+
+  // Signature with a bit set for each component type in Ts
+  template<typename... Ts>
+  static inline const Signature signatureOf = [] {
+    Signature mask;
+    (mask.set(componentId<Ts>), ...);
+    return mask;
+  }();
+
+  Registry() = default;
+  Registry(const Registry &) = delete;
+  Registry& operator=(const Registry &) = delete;
+
+  EntityId create() { return entities.create(); }
+
+  bool valid(EntityId entityId) const { return entities.valid(entityId); }
+
+  template<typename T, typename... TArgs>
+  T& addComponent(EntityId entityId, TArgs&&... mArgs) {
+    assert(valid(entityId) && "Entity not found!");
+    Record& entity = entities[entityIndex(entityId)];
+    assert(!entity.componentBitset[componentId<T>] &&
+           "Component exists for entity!");
+
+    T& component = pool<T>().addComponent(entityId, std::forward<TArgs>(mArgs)...);
+    entity.componentBitset.set(componentId<T>);
+    return component;
+  }
+
+  template<typename T>
+  void removeComponent(EntityId entityId) {
+    assert(hasComponent<T>(entityId) && "Component does not exist for entity!");
+    entities[entityIndex(entityId)].componentBitset.reset(componentId<T>);
+    pool<T>().removeComponent(entityId);
+  }
+
+  template<typename T, typename... TArgs>
+  T& replaceComponent(EntityId entityId, TArgs&&... mArgs) {
+    removeComponent<T>(entityId);
+    return addComponent<T>(entityId, std::forward<TArgs>(mArgs)...);
+  }
+
+  template<typename T>
+  T& getComponent(EntityId entityId) {
+    assert(hasComponent<T>(entityId) && "Entity does not have this component!");
+    return pool<T>().getComponent(entityId);
+  }
+
+  template<typename T>
+  T* tryGetComponent(EntityId entityId) {
+    if (!hasComponent<T>(entityId))
+      return nullptr;
+    return &pool<T>().getComponent(entityId);
+  }
+
+  template<typename T>
+  bool hasComponent(EntityId entityId) const {
+    return valid(entityId) &&
+           entities[entityIndex(entityId)].componentBitset[componentId<T>];
+  }
+
+  /*
+   * Return true if the entity holds every component in Ts, with one masked
+   * compare of its signature
+   */
+  template<typename... Ts>
+  bool hasComponents(EntityId entityId) const {
+    const Signature &mask = signatureOf<Ts...>;
+    return valid(entityId) &&
+           (entities[entityIndex(entityId)].componentBitset & mask) == mask;
+  }
+
+  template<typename... Ts>
+  StaticView<Registry, Ts...> view() {
+    static_assert(sizeof...(Ts) > 0, "View needs at least one component");
+    return StaticView<Registry, Ts...>(this);
+  }
+
+  void destroy(EntityId entityId) {
+    if (!valid(entityId))
+      return;
+
+    const Signature &signature = entities[entityIndex(entityId)].componentBitset;
+    ((signature[componentId<Components>]
+          ? pool<Components>().removeComponent(entityId)
+          : void()),
+     ...);
+    entities.release(entityIndex(entityId));
+  }
+
+  void clear() {
+    (pool<Components>().clear(), ...);
+    entities.releaseAll();
+  }
+
+  template<typename T>
+  ComponentArrayFor<T>& pool() {
+    return std::get<componentId<T>>(pools);
+  }
+
+private:
+  EntityTable<Record> entities = {};
+  std::tuple<ComponentArrayFor<Components>...> pools;
+};
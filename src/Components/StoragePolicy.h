@@ -0,0 +1,43 @@
+#pragma once
+
+#include <type_traits>
+
+/*
+ * How the components of one type are stored:
+ *
+ *   Dense     - paged pool with a sparse set index. The default, suited to
+ *               types most entities have (Transform, Sprite).
+ *   Sparse    - hash map from entity to component. No sparse pages, so it
+ *               suits types only a handful of entities have (Dialogue).
+ *   Singleton - a single slot, for types at most one entity has at a time
+ *               (Map, the input controllers).
+ *   Tag       - no storage at all, only the entity's signature bit. Only
+ *               empty types can be tags.
+ */
+enum class StoragePolicy { Dense, Sparse, Singleton, Tag };
+
+/*
+ * Storage policy for component type T. A component picks its policy by
+ * declaring
+ *
+ *   static constexpr StoragePolicy storagePolicy = StoragePolicy::Sparse;
+ *
+ * or, for types that can't be edited, by specialising ComponentTraits.
+ * Otherwise empty types are tags and everything else is dense.
+ */
+template<typename T, typename = void>
+struct ComponentTraits {
+  static constexpr StoragePolicy storagePolicy =
+      std::is_empty_v<T> ? StoragePolicy::Tag : StoragePolicy::Dense;
+};
+
+template<typename T>
+struct ComponentTraits<T, std::void_t<decltype(T::storagePolicy)>> {
+  static constexpr StoragePolicy storagePolicy = T::storagePolicy;
+};
+
+template<typename T>
+inline constexpr StoragePolicy storagePolicyOf = ComponentTraits<T>::storagePolicy;
+
+template<typename T>
+inline constexpr bool isTagComponent = storagePolicyOf<T> == StoragePolicy::Tag;
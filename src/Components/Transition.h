@@ -2,22 +2,71 @@
 
 #include "SDL3/SDL_rect.h"
 #include "SDL3_mixer/SDL_mixer.h"
+#include "Snapshot.h"
 #include "Transform.h"
+#include "StoragePolicy.h"
 #include <string>
+#include <utility>
 
 class Transition {
 public:
+  // Only a few entities per map have one
+  static constexpr StoragePolicy storagePolicy = StoragePolicy::Sparse;
+
   SDL_FRect collider;
   std::string mapPath;
-  Mix_Chunk *sound;
+  std::string soundPath;
+  Mix_Chunk *sound = nullptr;
 
-  Transition(Transform &transform, std::string mapPath, Mix_Chunk *sound) {
-    collider.x = transform.position.x;
-    collider.y = transform.position.y;
-    collider.w = transform.width;
-    collider.h = transform.height;
+  // The sound (if any) is loaded from soundPath
+  Transition(Transform &transform, std::string mapPath,
+             std::string soundPath = "")
+      : Transition(SDL_FRect{transform.position.x, transform.position.y,
+                             transform.width, transform.height},
+                   std::move(mapPath), std::move(soundPath)) {}
+
+  Transition(SDL_FRect collider, std::string mapPath, std::string soundPath) {
+    this->collider = collider;
     this->mapPath = mapPath;
-    this->sound = sound;
+    this->soundPath = soundPath;
+    if (!this->soundPath.empty())
+      sound = Mix_LoadWAV(this->soundPath.c_str());
+  }
+
+  // The sound belongs to one transition at a time; moves hand it over
+  Transition(const Transition &) = delete;
+  Transition &operator=(const Transition &) = delete;
+
+  Transition(Transition &&other) noexcept
+      : collider(other.collider), mapPath(std::move(other.mapPath)),
+        soundPath(std::move(other.soundPath)),
+        sound(std::exchange(other.sound, nullptr)) {}
+
+  Transition &operator=(Transition &&other) noexcept {
+    if (this != &other) {
+      clean();
+      collider = other.collider;
+      mapPath = std::move(other.mapPath);
+      soundPath = std::move(other.soundPath);
+      sound = std::exchange(other.sound, nullptr);
+    }
+    return *this;
+  }
+
+  /*
+   * Snapshot hooks. The sound is loaded again from its path on restore.
+   */
+  void saveSnapshot(SnapshotWriter &out) const {
+    out.write(collider);
+    out.writeString(mapPath);
+    out.writeString(soundPath);
+  }
+
+  static Transition loadSnapshot(SnapshotReader &in) {
+    SDL_FRect collider = in.read<SDL_FRect>();
+    std::string mapPath = in.readString();
+    std::string soundPath = in.readString();
+    return Transition(collider, mapPath, in.ok() ? soundPath : "");
   }
 
   void update(Transform &transform) {
@@ -25,5 +74,10 @@ public:
     collider.y = transform.position.y;
   }
 
+  void clean() {
+    Mix_FreeChunk(sound);
+    sound = nullptr;
+  }
+
 private:
 };
@@ -8,5 +8,7 @@ static const int DEFAULT_RENDER_SCALE = 4;
 static const int TILE_SIZE = 16;
 static const float PLAYER_SPEED = 50.0f; // pixels per second
 static const bool RENDER_COLLIDERS = false;
+static const bool LOG_SYSTEM_TIMINGS = false;
+static const int SYSTEM_TIMING_LOG_INTERVAL = 300; // frames
 
 static const std::string ENTRY_MAP = "level1.tmj";
@@ -5,14 +5,15 @@
 #include "SDL3/SDL_video.h"
 #include "SDL3_ttf/SDL_ttf.h"
 #include "SDL3_mixer/SDL_mixer.h"
+#include "TextureManager.h"
 
 // Define static members
 SDL_Renderer* Engine::renderer = nullptr;
 MapData Engine::mapData = {};
 int Engine::mapPixelHeight = SCREEN_HEIGHT;
 int Engine::mapPixelWidth = SCREEN_WIDTH;
-EntityId Engine::playerId = 0;
-EntityId Engine::mapId = 0;
+EntityId Engine::playerId = nullEntity;
+EntityId Engine::mapId = nullEntity;
 
 Engine::Engine(const char* windowTitle, int width, int height)
     : window(nullptr), 
@@ -133,9 +134,20 @@ void Engine::iterate() {
   if (!running)
     return;
 
-  // Update
+  // Keep component changes around for one full frame, so every system and
+  // the game see them once
+  std::uint64_t frameChangeVersion = registry.changeVersion();
+  registry.trimChanges(lastFrameChangeVersion);
+  lastFrameChangeVersion = frameChangeVersion;
+
+  // Update systems, then the game's own per-frame logic
+  scheduler.run(registry);
   gameImpl->onUpdate();
 
+  frameCount++;
+  if (LOG_SYSTEM_TIMINGS && frameCount % SYSTEM_TIMING_LOG_INTERVAL == 0)
+    logSystemTimings();
+
   // Render
   SDL_SetRenderDrawColor(renderer, 0, 0, 0, 255);
   SDL_RenderClear(renderer);
@@ -148,6 +160,10 @@ void Engine::iterate() {
 void Engine::cleanup() {
   gameImpl->onCleanup();
 
+  // Anything still holding a cached texture is past using it now
+  TextureManager::ClearTextureCache();
+  TextureManager::ClearTextCache();
+
   if (renderer) {
     SDL_DestroyRenderer(renderer);
     renderer = nullptr;
@@ -164,6 +180,40 @@ void Engine::cleanup() {
   SDL_Log("Engine cleaned up successfully!");
 }
 
+void Engine::logSystemTimings() {
+  SDL_Log("Systems: %.3f ms on %zu worker(s)", scheduler.getLastRunMs(),
+          scheduler.workerCount());
+  for (auto &timing : scheduler.getTimings()) {
+    SDL_Log("  %-20s %8.3f ms (avg %.3f ms)", timing.name.c_str(),
+            timing.lastMs, timing.averageMs);
+  }
+
+  const TextureCache::Stats &textures = TextureManager::GetTextureCache().stats();
+  SDL_Log("Textures: %zu cached (%zu KiB), %llu hits, %llu misses",
+          textures.textures, textures.bytesResident / 1024,
+          (unsigned long long)textures.hits,
+          (unsigned long long)textures.misses);
+
+  const TextRenderer::Stats &text = TextureManager::GetTextRenderer().stats();
+  SDL_Log("Text: %zu font(s), %zu page(s), %llu glyphs rasterised, "
+          "%llu layouts built",
+          text.fonts, text.pages, (unsigned long long)text.glyphsRasterised,
+          (unsigned long long)text.layoutsBuilt);
+
+  const TextureManager::MessageCache::Stats &messages =
+      TextureManager::GetMessageCacheStats();
+  SDL_Log("Text cache: %zu message(s) (%zu KiB), %llu hits, %llu misses",
+          messages.entries, messages.bytes / 1024,
+          (unsigned long long)messages.hits,
+          (unsigned long long)messages.misses);
+
+  const TextureManager::LayoutCache::Stats &layouts =
+      TextureManager::GetTextLayoutStats();
+  SDL_Log("Layout cache: %zu layout(s) (%zu KiB), %llu hits, %llu misses",
+          layouts.entries, layouts.bytes / 1024,
+          (unsigned long long)layouts.hits, (unsigned long long)layouts.misses);
+}
+
 void Engine::quit() {
   running = false;
   SDL_Log("Engine quit requested");
@@ -4,6 +4,7 @@
 #include "MapLoader.h"
 #include "IGame.h"
 #include "UI/UIManager.h"
+#include "Systems/Scheduler.h"
 #include "SDL3/SDL_events.h"
 #include <SDL3/SDL.h>
 #include <SDL3_image/SDL_image.h>
@@ -23,6 +24,19 @@ public:
   SDL_Window* getWindow() { return window; }
   EntityRegistry& getRegistry() { return registry; }
 
+  /*
+   * Register a system to run every frame before IGame::onUpdate. Systems run
+   * in parallel where their declared component access allows it.
+   */
+  template<typename T, typename... TArgs>
+  T& addSystem(TArgs&&... mArgs) {
+    return scheduler.addSystem<T>(std::forward<TArgs>(mArgs)...);
+  }
+
+  const std::vector<SystemTiming>& getSystemTimings() const {
+    return scheduler.getTimings();
+  }
+
   bool isRunning() const { return running; }
   void quit();
 
@@ -43,6 +57,12 @@ private:
   bool running;
 
   EntityRegistry registry = {};
+  Scheduler scheduler;
+  std::uint64_t frameCount = 0;
+  std::uint64_t lastFrameChangeVersion = 0;
+
   static EntityId playerId;
   static EntityId mapId;
+
+  void logSystemTimings();
 };
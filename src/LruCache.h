@@ -0,0 +1,125 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <iterator>
+#include <list>
+#include <unordered_map>
+#include <utility>
+
+/*
+ * Map from keys to values that holds at most a byte budget's worth of
+ * values, throwing out the least recently used ones to make room. The size
+ * of each value is given when it is inserted. onEvict is called on every
+ * value that leaves the cache, to release whatever it holds (textures...).
+ *
+ *   LruCache<std::string, Size> sizes(64 * 1024);
+ *   if (Size *size = sizes.find(text))
+ *     return *size;
+ *   return sizes.insert(text, measure(text), sizeof(Size));
+ */
+template<typename Key, typename Value, typename Hash = std::hash<Key>>
+class LruCache {
+public:
+  struct Stats {
+    std::uint64_t hits = 0;
+    std::uint64_t misses = 0;
+    std::uint64_t evictions = 0;
+    std::size_t entries = 0;
+    std::size_t bytes = 0;
+  };
+
+  using Evict = std::function<void(Value &)>;
+
+  explicit LruCache(std::size_t budget, Evict onEvict = {})
+      : budget(budget), onEvict(std::move(onEvict)) {}
+
+  LruCache(const LruCache &) = delete;
+  LruCache &operator=(const LruCache &) = delete;
+  ~LruCache() { clear(); }
+
+  /*
+   * Return the value stored for key and mark it most recently used, or
+   * nullptr if it isn't cached. Counts a hit or a miss.
+   */
+  Value *find(const Key &key) {
+    auto found = index.find(key);
+    if (found == index.end()) {
+      cacheStats.misses++;
+      return nullptr;
+    }
+    cacheStats.hits++;
+    entries.splice(entries.begin(), entries, found->second);
+    return &found->second->value;
+  }
+
+  /*
+   * Store value under key, replacing any value already there, then evict
+   * the least recently used values until the cache fits its budget again.
+   * The value just inserted is never evicted, even if it alone is over
+   * budget, so the returned reference stays valid until the next insert.
+   */
+  Value &insert(const Key &key, Value value, std::size_t bytes) {
+    auto found = index.find(key);
+    if (found != index.end())
+      erase(found->second);
+
+    entries.push_front({key, std::move(value), bytes});
+    index[key] = entries.begin();
+    cacheStats.entries++;
+    cacheStats.bytes += bytes;
+    trim();
+    return entries.front().value;
+  }
+
+  /*
+   * Change the byte budget, evicting straight away if the cache is now over
+   * it
+   */
+  void setBudget(std::size_t bytes) {
+    budget = bytes;
+    trim();
+  }
+
+  std::size_t getBudget() const { return budget; }
+
+  /*
+   * Evict everything
+   */
+  void clear() {
+    while (!entries.empty())
+      erase(std::prev(entries.end()));
+  }
+
+  const Stats &stats() const { return cacheStats; }
+
+private:
+  struct Entry {
+    Key key;
+    Value value;
+    std::size_t bytes;
+  };
+
+  // Most recently used first
+  std::list<Entry> entries = {};
+  std::unordered_map<Key, typename std::list<Entry>::iterator, Hash> index = {};
+  std::size_t budget;
+  Evict onEvict;
+  Stats cacheStats = {};
+
+  void trim() {
+    while (cacheStats.bytes > budget && entries.size() > 1)
+      erase(std::prev(entries.end()));
+  }
+
+  void erase(typename std::list<Entry>::iterator entry) {
+    if (onEvict)
+      onEvict(entry->value);
+    cacheStats.evictions++;
+    cacheStats.entries--;
+    cacheStats.bytes -= entry->bytes;
+    index.erase(entry->key);
+    entries.erase(entry);
+  }
+};
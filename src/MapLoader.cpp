@@ -1,6 +1,7 @@
 #include "MapLoader.h"
 #include "Components/Transform.h"
 #include "SDL3/SDL_filesystem.h"
+#include <algorithm>
 #include <exception>
 #include <filesystem>
 #include <iostream>
@@ -528,10 +529,12 @@ void MapLoader::addGidTexturesFromTileset(const fs::path &tilesetFile,
 
       std::string imageSource = tileImageNodes[0].getValue("source");
       fs::path filePath = tilesetFile.parent_path() / fs::path(imageSource);
-      gidTextures[firstGid + id] = {
-        firstGid,
-        fs::canonical(filePath).string()
-      };
+      std::string texPath = fs::canonical(filePath).string();
+      gidTextures[firstGid + id] = {firstGid, texPath};
+
+      std::vector<std::string> &images = mapData.objectImages;
+      if (std::find(images.begin(), images.end(), texPath) == images.end())
+        images.push_back(texPath);
     }
   }
 }
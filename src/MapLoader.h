@@ -42,6 +42,8 @@ struct MapData {
   Vector2D startPos = {0, 0};
   PlayerObject playerObject = {};
   std::string tilesetImg = "";
+  // Every image of the map's object tilesets, for packing into an atlas
+  std::vector<std::string> objectImages;
   std::unordered_map<int, MapObject> spriteVector;
   std::unordered_map<int, MapObject> spriteColliderVector;
   std::unordered_map<int, MapObject> colliderVector;
@@ -0,0 +1,58 @@
+#include "SpriteBatch.h"
+#include "SDL3/SDL_log.h"
+#include <utility>
+
+void SpriteBatch::draw(SDL_Texture *texture, const SDL_FRect &srcRect,
+                       const SDL_FRect &destRect, SDL_FlipMode flip,
+                       SDL_FColor colour) {
+  if (!texture || texture->w == 0 || texture->h == 0)
+    return;
+
+  if (runs.empty() || runs.back().texture != texture)
+    runs.push_back({texture, vertices.size(), 0});
+  runs.back().quadCount++;
+
+  float u0 = srcRect.x / float(texture->w);
+  float v0 = srcRect.y / float(texture->h);
+  float u1 = (srcRect.x + srcRect.w) / float(texture->w);
+  float v1 = (srcRect.y + srcRect.h) / float(texture->h);
+  if (flip & SDL_FLIP_HORIZONTAL)
+    std::swap(u0, u1);
+  if (flip & SDL_FLIP_VERTICAL)
+    std::swap(v0, v1);
+
+  float x0 = destRect.x;
+  float y0 = destRect.y;
+  float x1 = destRect.x + destRect.w;
+  float y1 = destRect.y + destRect.h;
+
+  vertices.push_back({{x0, y0}, colour, {u0, v0}});
+  vertices.push_back({{x1, y0}, colour, {u1, v0}});
+  vertices.push_back({{x1, y1}, colour, {u1, v1}});
+  vertices.push_back({{x0, y1}, colour, {u0, v1}});
+}
+
+void SpriteBatch::flush(SDL_Renderer *renderer) {
+  lastQuads = vertices.size() / 4;
+  lastCalls = runs.size();
+
+  // Grow the shared index list to fit the longest run
+  for (const Run &run : runs) {
+    for (std::size_t quad = indices.size() / 6; quad < run.quadCount; quad++) {
+      int first = int(quad * 4);
+      indices.insert(indices.end(), {first, first + 1, first + 2,
+                                     first + 2, first + 3, first});
+    }
+  }
+
+  for (const Run &run : runs) {
+    if (!SDL_RenderGeometry(renderer, run.texture,
+                            vertices.data() + run.firstVertex,
+                            int(run.quadCount * 4), indices.data(),
+                            int(run.quadCount * 6)))
+      SDL_Log("SDL_RenderGeometry Error: %s", SDL_GetError());
+  }
+
+  vertices.clear();
+  runs.clear();
+}
@@ -0,0 +1,54 @@
+#pragma once
+
+#include "SDL3/SDL_rect.h"
+#include "SDL3/SDL_render.h"
+#include <cstddef>
+#include <vector>
+
+/*
+ * Collects textured quads and submits them with one SDL_RenderGeometry call
+ * per run of consecutive quads that share a texture. Quads are drawn in the
+ * order they were added, so a Y-sorted list of sprites stays sorted; the
+ * fewer times the texture changes, the fewer calls are made.
+ */
+class SpriteBatch {
+public:
+  /*
+   * Queue the srcRect part of texture to be drawn at destRect. Flips are
+   * applied by swapping texture coordinates, and the texture is multiplied
+   * by colour, so white glyphs can be drawn in any colour.
+   */
+  void draw(SDL_Texture *texture, const SDL_FRect &srcRect,
+            const SDL_FRect &destRect, SDL_FlipMode flip = SDL_FLIP_NONE,
+            SDL_FColor colour = {1.0f, 1.0f, 1.0f, 1.0f});
+
+  /*
+   * Submit everything queued so far and start again. The buffers keep their
+   * capacity, so a steady scene doesn't allocate once it has warmed up.
+   */
+  void flush(SDL_Renderer *renderer);
+
+  bool empty() const { return runs.empty(); }
+
+  // Quads and SDL_RenderGeometry calls in the last flush
+  std::size_t lastQuadCount() const { return lastQuads; }
+  std::size_t lastCallCount() const { return lastCalls; }
+
+private:
+  // Consecutive quads using the same texture
+  struct Run {
+    SDL_Texture *texture;
+    std::size_t firstVertex;
+    std::size_t quadCount;
+  };
+
+  std::vector<SDL_Vertex> vertices = {};
+  std::vector<Run> runs = {};
+
+  // 0 1 2, 2 3 0 for every quad. Each run is submitted starting at its own
+  // first vertex, so one shared index list serves them all.
+  std::vector<int> indices = {};
+
+  std::size_t lastQuads = 0;
+  std::size_t lastCalls = 0;
+};
@@ -0,0 +1,134 @@
+#include "Scheduler.h"
+#include <chrono>
+#include <condition_variable>
+#include <deque>
+#include <exception>
+#include <mutex>
+
+using Clock = std::chrono::steady_clock;
+
+// Weight of the latest frame in the moving average
+static const double timingSmoothing = 0.1;
+
+void Scheduler::add(std::unique_ptr<System> system) {
+  std::size_t index = nodes.size();
+
+  // Depend on every earlier system whose access conflicts with this one, so
+  // conflicting systems keep the order they were added in
+  Node node = {std::move(system)};
+  for (std::size_t i = 0; i < index; i++) {
+    if (nodes[i].system->getAccess().conflictsWith(node.system->getAccess())) {
+      nodes[i].dependents.push_back(index);
+      node.dependencyCount++;
+    }
+  }
+
+  timings.push_back({node.system->getName()});
+  nodes.push_back(std::move(node));
+}
+
+void Scheduler::run(EntityRegistry &registry) {
+  auto start = Clock::now();
+
+  std::vector<std::size_t> remaining(nodes.size());
+  std::vector<std::size_t> ready = {};
+  for (std::size_t i = 0; i < nodes.size(); i++) {
+    remaining[i] = nodes[i].dependencyCount;
+    if (remaining[i] == 0)
+      ready.push_back(i);
+  }
+
+  // Systems that finished on a worker, waiting to release their dependents
+  std::mutex mutex;
+  std::condition_variable finishedSignal;
+  std::vector<std::size_t> finished = {};
+  std::exception_ptr error = nullptr;
+
+  std::deque<std::size_t> mainThreadQueue = {};
+  std::vector<std::size_t> completed = {};
+  std::size_t doneCount = 0;
+
+  while (doneCount < nodes.size()) {
+    for (std::size_t index : ready) {
+      if (pool.workerCount() == 0 || nodes[index].system->getAccess().exclusive) {
+        mainThreadQueue.push_back(index);
+        continue;
+      }
+
+      pool.submit([this, index, &registry, &mutex, &finishedSignal, &finished,
+                   &error] {
+        std::exception_ptr systemError = nullptr;
+        try {
+          execute(index, registry);
+        } catch (...) {
+          systemError = std::current_exception();
+        }
+
+        // Notify while holding the lock, as run() may return and destroy
+        // the condition variable as soon as the lock is released
+        std::lock_guard<std::mutex> lock(mutex);
+        finished.push_back(index);
+        if (systemError && !error)
+          error = systemError;
+        finishedSignal.notify_one();
+      });
+    }
+    ready.clear();
+
+    // Run one main thread system while the workers are busy
+    completed.clear();
+    if (!mainThreadQueue.empty()) {
+      std::size_t index = mainThreadQueue.front();
+      mainThreadQueue.pop_front();
+      try {
+        execute(index, registry);
+      } catch (...) {
+        std::lock_guard<std::mutex> lock(mutex);
+        if (!error)
+          error = std::current_exception();
+      }
+      completed.push_back(index);
+    }
+
+    {
+      std::unique_lock<std::mutex> lock(mutex);
+      if (completed.empty())
+        finishedSignal.wait(lock, [&finished] { return !finished.empty(); });
+      completed.insert(completed.end(), finished.begin(), finished.end());
+      finished.clear();
+    }
+
+    // Release systems whose dependencies have all finished
+    for (std::size_t index : completed) {
+      doneCount++;
+      for (std::size_t dependent : nodes[index].dependents) {
+        if (--remaining[dependent] == 0)
+          ready.push_back(dependent);
+      }
+    }
+  }
+
+  // Sync point: apply the structural changes queued by systems
+  for (auto &node : nodes)
+    node.system->getCommands().flush(registry);
+
+  std::chrono::duration<double, std::milli> elapsed = Clock::now() - start;
+  lastRunMs = elapsed.count();
+
+  if (error)
+    std::rethrow_exception(error);
+}
+
+void Scheduler::execute(std::size_t index, EntityRegistry &registry) {
+  auto start = Clock::now();
+  nodes[index].system->update(registry);
+  std::chrono::duration<double, std::milli> elapsed = Clock::now() - start;
+
+  // Each system only ever writes its own entry, so no locking is needed
+  SystemTiming &timing = timings[index];
+  timing.lastMs = elapsed.count();
+  timing.averageMs = timing.averageMs == 0
+                         ? timing.lastMs
+                         : timing.averageMs +
+                               timingSmoothing * (timing.lastMs - timing.averageMs);
+}
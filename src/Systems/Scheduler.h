@@ -0,0 +1,74 @@
+#pragma once
+
+#include "System.h"
+#include "ThreadPool.h"
+#include <cstddef>
+#include <memory>
+#include <string>
+#include <vector>
+
+/*
+ * Time spent in a system, in milliseconds
+ */
+struct SystemTiming {
+  std::string name;
+  double lastMs = 0;
+  double averageMs = 0; // exponential moving average over recent frames
+};
+
+/*
+ * Runs registered systems once per frame. A dependency graph is built from
+ * the systems' declared component access: a system waits for every earlier
+ * system it conflicts with, and systems with no path between them run
+ * concurrently on the worker pool.
+ */
+class Scheduler {
+public:
+  // Run systems on the shared pool, which parallel view iteration uses too
+  Scheduler() : pool(ThreadPool::shared()) {}
+
+  // Run systems on a pool of our own with the given number of workers
+  explicit Scheduler(std::size_t workerCount)
+      : ownedPool(std::make_unique<ThreadPool>(workerCount)), pool(*ownedPool) {}
+
+  template<typename T, typename... TArgs>
+  T& addSystem(TArgs&&... mArgs) {
+    auto system = std::make_unique<T>(std::forward<TArgs>(mArgs)...);
+    T &ref = *system;
+    add(std::move(system));
+    return ref;
+  }
+
+  void add(std::unique_ptr<System> system);
+
+  /*
+   * Run every system once, returning when all of them have finished, then
+   * flush the systems' command buffers in the order the systems were added.
+   * Exceptions thrown by a system are rethrown here on the calling thread.
+   */
+  void run(EntityRegistry &registry);
+
+  // Timings in the order the systems were added
+  const std::vector<SystemTiming>& getTimings() const { return timings; }
+
+  // Wall-clock time of the last run(), in milliseconds
+  double getLastRunMs() const { return lastRunMs; }
+
+  std::size_t size() const { return nodes.size(); }
+  std::size_t workerCount() const { return pool.workerCount(); }
+
+private:
+  struct Node {
+    std::unique_ptr<System> system;
+    std::vector<std::size_t> dependents = {};
+    std::size_t dependencyCount = 0;
+  };
+
+  std::vector<Node> nodes = {};
+  std::vector<SystemTiming> timings = {};
+  double lastRunMs = 0;
+  std::unique_ptr<ThreadPool> ownedPool = nullptr;
+  ThreadPool &pool;
+
+  void execute(std::size_t index, EntityRegistry &registry);
+};
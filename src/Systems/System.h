@@ -0,0 +1,72 @@
+#pragma once
+
+#include "../Components/CommandBuffer.h"
+#include "../Components/ECS.h"
+#include <string>
+
+/*
+ * Components a system reads and writes. The scheduler runs two systems at the
+ * same time only if neither writes a component the other one touches.
+ */
+struct SystemAccess {
+  Signature reads = {};
+  Signature writes = {};
+
+  // Exclusive systems run on the main thread with nothing else alongside
+  // them. Use this for systems that create or destroy entities, add or remove
+  // components, or touch state outside the registry (SDL, audio, UI).
+  bool exclusive = false;
+
+  bool conflictsWith(const SystemAccess &other) const {
+    return exclusive || other.exclusive ||
+           (writes & (other.reads | other.writes)).any() ||
+           (other.writes & reads).any();
+  }
+};
+
+/*
+ * A unit of per-frame game logic registered with the Engine. Subclasses
+ * declare their component access in the constructor, e.g.
+ *
+ *   AnimationSystem() : System("Animation") {
+ *     reads<Transform>();
+ *     writes<Sprite>();
+ *   }
+ *
+ * and the scheduler uses the declarations to decide which systems can run in
+ * parallel. Systems that conflict run in the order they were added.
+ *
+ * Non-exclusive systems must not change the registry structure directly.
+ * Queue creates, destroys and component adds/removes on commands instead;
+ * the scheduler flushes every system's buffer once all systems have run.
+ */
+class System {
+public:
+  explicit System(std::string name) : name(std::move(name)) {}
+  virtual ~System() = default;
+
+  virtual void update(EntityRegistry &registry) = 0;
+
+  const std::string& getName() const { return name; }
+  const SystemAccess& getAccess() const { return access; }
+  CommandBuffer& getCommands() { return commands; }
+
+protected:
+  template<typename... Ts>
+  void reads() {
+    access.reads |= makeSignature<Ts...>();
+  }
+
+  template<typename... Ts>
+  void writes() {
+    access.writes |= makeSignature<Ts...>();
+  }
+
+  void exclusive() { access.exclusive = true; }
+
+  CommandBuffer commands = {};
+
+private:
+  std::string name;
+  SystemAccess access = {};
+};
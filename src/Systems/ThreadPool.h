@@ -0,0 +1,287 @@
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <cassert>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <exception>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <numeric>
+#include <thread>
+#include <vector>
+
+/*
+ * Fixed set of worker threads, each with its own task queue. Workers take
+ * their newest task first and steal the oldest task from another worker when
+ * their own queue is empty, so tasks spawned by a task tend to stay on the
+ * thread whose cache they are warm in. A pool with no workers is valid, and
+ * callers are expected to run tasks themselves in that case (e.g. on web
+ * builds without thread support); parallelFor() already does.
+ */
+class ThreadPool {
+public:
+  static constexpr std::size_t cacheLineSize = 64;
+
+  explicit ThreadPool(std::size_t workerCount) : queues(workerCount) {
+    for (std::size_t i = 0; i < workerCount; i++)
+      workers.emplace_back([this, i] { workerLoop(i); });
+  }
+
+  ThreadPool(const ThreadPool &) = delete;
+  ThreadPool& operator=(const ThreadPool &) = delete;
+
+  ~ThreadPool() {
+    {
+      std::lock_guard<std::mutex> lock(mutex);
+      stopping = true;
+    }
+    wake.notify_all();
+    for (auto &worker : workers)
+      worker.join();
+  }
+
+  std::size_t workerCount() const { return workers.size(); }
+
+  /*
+   * Queue a task. Tasks submitted from one of the pool's workers go on that
+   * worker's own queue, others are spread over the workers in turn.
+   */
+  void submit(std::function<void()> task) {
+    assert(!queues.empty() && "Pool has no workers to run the task!");
+    {
+      std::lock_guard<std::mutex> lock(mutex);
+      std::size_t target = currentPool == this
+                               ? currentWorker
+                               : nextQueue++ % queues.size();
+      queues[target].push_back(std::move(task));
+      queuedCount++;
+    }
+    wake.notify_one();
+  }
+
+  /*
+   * Call func(begin, end) over [0, count) split into chunks of chunkSize,
+   * returning once every chunk has run. Each participating thread starts on
+   * its own contiguous run of chunks and steals chunks from the back of
+   * other threads' runs when it finishes early. The calling thread takes part,
+   * so this is safe to call from inside a pool task. The first exception
+   * thrown by func is rethrown here after the remaining chunks have run.
+   */
+  template<typename Func>
+  void parallelFor(std::size_t count, std::size_t chunkSize, Func &&func) {
+    chunkSize = std::max<std::size_t>(1, chunkSize);
+    std::size_t chunkCount = (count + chunkSize - 1) / chunkSize;
+    std::size_t participants = std::min(workerCount() + 1, chunkCount);
+    if (participants <= 1) {
+      if (count > 0)
+        func(std::size_t(0), count);
+      return;
+    }
+
+    // Helpers may only get to run after this call has returned, so the job
+    // state is shared with them. func itself is only called while chunks are
+    // left, which is never after this call returns.
+    auto job = std::make_shared<ParallelJob>(chunkCount, participants);
+    job->runChunk = [&func, count, chunkSize](std::size_t chunk) {
+      std::size_t begin = chunk * chunkSize;
+      func(begin, std::min(begin + chunkSize, count));
+    };
+
+    for (std::size_t i = 1; i < participants; i++)
+      submit([job, i] { job->work(i); });
+    job->work(0);
+    job->wait();
+
+    if (job->error)
+      std::rethrow_exception(job->error);
+  }
+
+  /*
+   * Chunk size for parallelFor() over count elements of parallel arrays of
+   * Ts, indexed by the loop index, and gives each participating thread a few
+   * chunks to balance uneven work. The size is a whole number of cache lines
+   * in each of those arrays (if they start on a line), so two chunks never
+   * write to the same line of them. Only list types that really are laid out
+   * that way: data reached some other way (through an entity lookup, say)
+   * gets no such guarantee.
+   */
+  template<typename... Ts>
+  std::size_t chunkSizeFor(std::size_t count,
+                           std::size_t minChunkSize = 256) const {
+    // Elements per chunk needed to end every array on a cache line boundary
+    std::size_t step = 1;
+    ((step = std::lcm(step, cacheLineSize / std::gcd(cacheLineSize, sizeof(Ts)))),
+     ...);
+
+    std::size_t chunks = (workerCount() + 1) * chunksPerThread;
+    std::size_t size = std::max(minChunkSize, (count + chunks - 1) / chunks);
+    return (size + step - 1) / step * step;
+  }
+
+  /*
+   * Number of workers to use by default: one per hardware thread, leaving one
+   * for the main thread
+   */
+  static std::size_t defaultWorkerCount() {
+#if defined(__EMSCRIPTEN__) && !defined(__EMSCRIPTEN_PTHREADS__)
+    return 0;
+#else
+    unsigned int hardwareThreads = std::thread::hardware_concurrency();
+    return hardwareThreads > 1 ? hardwareThreads - 1 : 0;
+#endif
+  }
+
+  /*
+   * Pool shared by the engine's scheduler and parallel view iteration,
+   * created with the default worker count on first use
+   */
+  static ThreadPool& shared() {
+    static ThreadPool pool(defaultWorkerCount());
+    return pool;
+  }
+
+private:
+  static constexpr std::size_t chunksPerThread = 4;
+
+  /*
+   * State of one parallelFor() call. Each participant owns a range of chunk
+   * indices packed into one atomic word (begin in the high half, end in the
+   * low half): the owner claims from the front and thieves from the back,
+   * both with a compare-exchange on the same word, so every chunk is claimed
+   * exactly once.
+   */
+  struct ParallelJob {
+    std::unique_ptr<std::atomic<std::uint64_t>[]> ranges;
+    std::size_t participants;
+    std::function<void(std::size_t)> runChunk = {};
+
+    std::atomic<std::size_t> remaining;
+    std::mutex mutex;
+    std::condition_variable finished;
+    std::exception_ptr error = nullptr;
+
+    ParallelJob(std::size_t chunkCount, std::size_t participants)
+        : ranges(new std::atomic<std::uint64_t>[participants]),
+          participants(participants), remaining(chunkCount) {
+      for (std::size_t i = 0; i < participants; i++) {
+        std::uint64_t begin = chunkCount * i / participants;
+        std::uint64_t end = chunkCount * (i + 1) / participants;
+        ranges[i].store(begin << 32 | end, std::memory_order_relaxed);
+      }
+    }
+
+    void work(std::size_t self) {
+      std::size_t chunk;
+      while (claimFront(self, chunk) || steal(self, chunk)) {
+        try {
+          runChunk(chunk);
+        } catch (...) {
+          std::lock_guard<std::mutex> lock(mutex);
+          if (!error)
+            error = std::current_exception();
+        }
+
+        if (remaining.fetch_sub(1, std::memory_order_acq_rel) == 1) {
+          std::lock_guard<std::mutex> lock(mutex);
+          finished.notify_all();
+        }
+      }
+    }
+
+    void wait() {
+      std::unique_lock<std::mutex> lock(mutex);
+      finished.wait(lock, [this] {
+        return remaining.load(std::memory_order_acquire) == 0;
+      });
+    }
+
+    bool claimFront(std::size_t owner, std::size_t &chunk) {
+      std::uint64_t range = ranges[owner].load(std::memory_order_relaxed);
+      while (true) {
+        std::uint64_t begin = range >> 32, end = range & 0xFFFFFFFF;
+        if (begin >= end)
+          return false;
+        if (ranges[owner].compare_exchange_weak(range, (begin + 1) << 32 | end,
+                                                std::memory_order_acq_rel)) {
+          chunk = std::size_t(begin);
+          return true;
+        }
+      }
+    }
+
+    bool claimBack(std::size_t victim, std::size_t &chunk) {
+      std::uint64_t range = ranges[victim].load(std::memory_order_relaxed);
+      while (true) {
+        std::uint64_t begin = range >> 32, end = range & 0xFFFFFFFF;
+        if (begin >= end)
+          return false;
+        if (ranges[victim].compare_exchange_weak(range, begin << 32 | (end - 1),
+                                                 std::memory_order_acq_rel)) {
+          chunk = std::size_t(end - 1);
+          return true;
+        }
+      }
+    }
+
+    bool steal(std::size_t self, std::size_t &chunk) {
+      for (std::size_t i = 1; i < participants; i++) {
+        if (claimBack((self + i) % participants, chunk))
+          return true;
+      }
+      return false;
+    }
+  };
+
+  static inline thread_local const ThreadPool *currentPool = nullptr;
+  static inline thread_local std::size_t currentWorker = 0;
+
+  std::vector<std::thread> workers = {};
+  std::vector<std::deque<std::function<void()>>> queues;
+  std::size_t queuedCount = 0;
+  std::size_t nextQueue = 0;
+  std::mutex mutex;
+  std::condition_variable wake;
+  bool stopping = false;
+
+  // Take the newest task from our own queue, or else the oldest from another
+  // worker's. Must be called with the mutex held.
+  bool takeTask(std::size_t worker, std::function<void()> &task) {
+    if (!queues[worker].empty()) {
+      task = std::move(queues[worker].back());
+      queues[worker].pop_back();
+      return true;
+    }
+    for (std::size_t i = 1; i < queues.size(); i++) {
+      auto &victim = queues[(worker + i) % queues.size()];
+      if (!victim.empty()) {
+        task = std::move(victim.front());
+        victim.pop_front();
+        return true;
+      }
+    }
+    return false;
+  }
+
+  void workerLoop(std::size_t worker) {
+    currentPool = this;
+    currentWorker = worker;
+
+    while (true) {
+      std::function<void()> task;
+      {
+        std::unique_lock<std::mutex> lock(mutex);
+        wake.wait(lock, [this] { return stopping || queuedCount > 0; });
+        if (stopping && queuedCount == 0)
+          return;
+        takeTask(worker, task);
+        queuedCount--;
+      }
+      task();
+    }
+  }
+};
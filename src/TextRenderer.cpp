@@ -0,0 +1,267 @@
+#include "TextRenderer.h"
+#include "SDL3/SDL_log.h"
+#include "SDL3/SDL_stdinc.h"
+#include "SDL3/SDL_surface.h"
+#include "SDL3_ttf/SDL_ttf.h"
+#include <algorithm>
+
+namespace {
+
+// Gap left between glyphs on a page
+constexpr int padding = 1;
+
+std::vector<std::uint32_t> decodeUtf8(std::string_view text) {
+  std::vector<std::uint32_t> codepoints;
+  codepoints.reserve(text.size());
+  const char *next = text.data();
+  std::size_t remaining = text.size();
+  while (remaining > 0)
+    codepoints.push_back(SDL_StepUTF8(&next, &remaining));
+  return codepoints;
+}
+
+} // namespace
+
+TextRenderer::~TextRenderer() { clear(); }
+
+const TextRenderer::Layout *TextRenderer::layout(SDL_Renderer *renderer,
+                                                 const std::string &fontPath,
+                                                 float pointsize,
+                                                 std::string_view text,
+                                                 int wraplength) {
+  Font *font = openFont(fontPath, pointsize);
+  if (!font)
+    return nullptr;
+
+  std::string key = fontPath;
+  key.push_back('\0');
+  key += std::to_string(pointsize);
+  key.push_back('\0');
+  key += std::to_string(wraplength);
+  key.push_back('\0');
+  key += text;
+
+  if (const Layout *cached = layouts.find(key))
+    return cached;
+
+  Layout layout;
+  buildLayout(renderer, *font, text, wraplength, layout);
+  textStats.layoutsBuilt++;
+  std::size_t bytes = sizeof(Layout) + key.size() +
+                      layout.quads.capacity() * sizeof(Quad);
+  return &layouts.insert(key, std::move(layout), bytes);
+}
+
+void TextRenderer::draw(SpriteBatch &batch, const Layout &layout,
+                        SDL_FPoint position, SDL_Color colour,
+                        std::size_t characters) {
+  // Text is always drawn opaque, as it was when rendered by SDL_ttf
+  SDL_FColor tint = {colour.r / 255.0f, colour.g / 255.0f, colour.b / 255.0f,
+                     1.0f};
+  for (const Quad &quad : layout.quads) {
+    if (quad.index >= characters)
+      break;
+    SDL_FRect destRect = quad.destRect;
+    destRect.x += position.x;
+    destRect.y += position.y;
+    batch.draw(quad.page, quad.srcRect, destRect, SDL_FLIP_NONE, tint);
+  }
+}
+
+void TextRenderer::clear() {
+  // Layouts point into the pages
+  layouts.clear();
+  for (auto &[key, font] : fonts) {
+    for (SDL_Texture *page : font->pages)
+      SDL_DestroyTexture(page);
+    TTF_CloseFont(font->font);
+  }
+  fonts.clear();
+  textStats.fonts = 0;
+  textStats.pages = 0;
+}
+
+TextRenderer::Font *TextRenderer::openFont(const std::string &fontPath,
+                                           float pointsize) {
+  auto key = std::make_pair(fontPath, pointsize);
+  auto found = fonts.find(key);
+  if (found != fonts.end())
+    return found->second.get();
+
+  TTF_Font *ttfFont = TTF_OpenFont(fontPath.c_str(), pointsize);
+  if (!ttfFont) {
+    SDL_Log("TTF_OpenFont: %s\n", SDL_GetError());
+    return nullptr;
+  }
+
+  auto font = std::make_unique<Font>();
+  font->font = ttfFont;
+  font->lineSkip = float(TTF_GetFontLineSkip(ttfFont));
+  font->height = float(TTF_GetFontHeight(ttfFont));
+  textStats.fonts++;
+  return (fonts[key] = std::move(font)).get();
+}
+
+const TextRenderer::Glyph &TextRenderer::glyph(SDL_Renderer *renderer,
+                                               Font &font,
+                                               std::uint32_t codepoint) {
+  auto found = font.glyphs.find(codepoint);
+  if (found != font.glyphs.end())
+    return found->second;
+
+  Glyph &glyph = font.glyphs[codepoint];
+  int minX = 0, maxX = 0, minY = 0, maxY = 0, advance = 0;
+  if (!TTF_GetGlyphMetrics(font.font, codepoint, &minX, &maxX, &minY, &maxY,
+                           &advance))
+    return glyph;
+  glyph.advance = float(advance);
+
+  // Glyphs are rendered in white and tinted when drawn, so one copy serves
+  // every colour. The bitmap starts at the pen or, for glyphs that reach
+  // back, before it.
+  glyph.offsetX = float(std::min(0, minX));
+  if (codepoint == ' ' || maxX <= minX)
+    return glyph;
+
+  SDL_Surface *rendered =
+      TTF_RenderGlyph_Solid(font.font, codepoint, {255, 255, 255, 255});
+  if (!rendered)
+    return glyph;
+
+  // Solid glyphs are paletted with a colour key; converting them turns the
+  // key into transparent alpha
+  SDL_Surface *converted = SDL_ConvertSurface(rendered, SDL_PIXELFORMAT_RGBA32);
+  SDL_DestroySurface(rendered);
+  if (converted) {
+    packGlyph(renderer, font, converted, glyph);
+    SDL_DestroySurface(converted);
+  }
+  textStats.glyphsRasterised++;
+  return glyph;
+}
+
+bool TextRenderer::packGlyph(SDL_Renderer *renderer, Font &font,
+                             SDL_Surface *surface, Glyph &glyph) {
+  int w = surface->w + padding;
+  int h = surface->h + padding;
+  if (w > pageSize || h > pageSize) {
+    SDL_Log("Glyph too large for a %d pixel text page", pageSize);
+    return false;
+  }
+
+  // Next shelf when this one is full, next page when the shelves are
+  if (font.shelfX + w > pageSize) {
+    font.shelfY += font.shelfHeight;
+    font.shelfX = 0;
+    font.shelfHeight = 0;
+  }
+  if (font.pages.empty() || font.shelfY + h > pageSize) {
+    SDL_Texture *page = SDL_CreateTexture(renderer, SDL_PIXELFORMAT_RGBA32,
+                                          SDL_TEXTUREACCESS_STATIC, pageSize,
+                                          pageSize);
+    if (!page) {
+      SDL_Log("Text page could not be created: %s", SDL_GetError());
+      return false;
+    }
+    std::vector<std::uint32_t> clear(std::size_t(pageSize) * pageSize, 0);
+    SDL_UpdateTexture(page, nullptr, clear.data(), pageSize * 4);
+    SDL_SetTextureBlendMode(page, SDL_BLENDMODE_BLEND);
+    SDL_SetTextureScaleMode(page, SDL_SCALEMODE_NEAREST);
+    font.pages.push_back(page);
+    font.shelfX = font.shelfY = font.shelfHeight = 0;
+    textStats.pages++;
+  }
+
+  SDL_Rect rect = {font.shelfX, font.shelfY, surface->w, surface->h};
+  SDL_Texture *page = font.pages.back();
+  if (!SDL_UpdateTexture(page, &rect, surface->pixels, surface->pitch)) {
+    SDL_Log("Glyph could not be uploaded: %s", SDL_GetError());
+    return false;
+  }
+  font.shelfX += w;
+  font.shelfHeight = std::max(font.shelfHeight, h);
+
+  glyph.page = page;
+  glyph.srcRect = {float(rect.x), float(rect.y), float(rect.w), float(rect.h)};
+  return true;
+}
+
+void TextRenderer::buildLayout(SDL_Renderer *renderer, Font &font,
+                               std::string_view text, int wraplength,
+                               Layout &layout) {
+  std::vector<std::uint32_t> codepoints = decodeUtf8(text);
+
+  auto advance = [&](std::size_t index, std::size_t lineStart) {
+    float width = glyph(renderer, font, codepoints[index]).advance;
+    int kerning = 0;
+    if (index > lineStart &&
+        TTF_GetGlyphKerning(font.font, codepoints[index - 1],
+                            codepoints[index], &kerning))
+      width += float(kerning);
+    return width;
+  };
+
+  // Split into lines, breaking at the last space before a line would pass
+  // the wrap length, or mid-word if a word won't fit on a line of its own
+  std::vector<std::pair<std::size_t, std::size_t>> lines;
+  const std::size_t noSpace = std::size_t(-1);
+  std::size_t lineStart = 0;
+  std::size_t lastSpace = noSpace;
+  float x = 0;
+  for (std::size_t index = 0; index < codepoints.size(); index++) {
+    std::uint32_t codepoint = codepoints[index];
+    if (codepoint == '\n') {
+      lines.push_back({lineStart, index});
+      lineStart = index + 1;
+      lastSpace = noSpace;
+      x = 0;
+      continue;
+    }
+
+    float width = advance(index, lineStart);
+    if (wraplength > 0 && codepoint != ' ' && index > lineStart &&
+        x + width > float(wraplength)) {
+      bool atSpace = lastSpace != noSpace;
+      lines.push_back({lineStart, atSpace ? lastSpace : index});
+      lineStart = atSpace ? lastSpace + 1 : index;
+      lastSpace = noSpace;
+
+      x = 0;
+      for (std::size_t carried = lineStart; carried < index; carried++)
+        x += advance(carried, lineStart);
+      width = advance(index, lineStart);
+    }
+
+    if (codepoint == ' ')
+      lastSpace = index;
+    x += width;
+  }
+  lines.push_back({lineStart, codepoints.size()});
+
+  // Place the glyphs, line by line
+  for (std::size_t line = 0; line < lines.size(); line++) {
+    auto [begin, end] = lines[line];
+    while (end > begin && codepoints[end - 1] == ' ')
+      end--;
+
+    float penX = 0;
+    float y = float(line) * font.lineSkip;
+    for (std::size_t index = begin; index < end; index++) {
+      float width = advance(index, begin);
+      const Glyph &placed = glyph(renderer, font, codepoints[index]);
+      float kerning = width - placed.advance;
+      if (placed.page) {
+        layout.quads.push_back(
+            {placed.page, placed.srcRect,
+             {penX + kerning + placed.offsetX, y, placed.srcRect.w,
+              placed.srcRect.h},
+             index});
+      }
+      penX += width;
+    }
+    layout.width = std::max(layout.width, penX);
+  }
+  layout.height = float(lines.size() - 1) * font.lineSkip + font.height;
+  layout.lineHeight = font.height;
+  layout.length = codepoints.size();
+}
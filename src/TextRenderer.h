@@ -0,0 +1,130 @@
+#pragma once
+
+#include "SDL3/SDL_pixels.h"
+#include "SDL3/SDL_rect.h"
+#include "LruCache.h"
+#include "SDL3/SDL_render.h"
+#include "SpriteBatch.h"
+#include <cstddef>
+#include <cstdint>
+#include <map>
+#include <memory>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+struct TTF_Font;
+
+/*
+ * Draws text from glyphs cached in atlas textures, instead of rasterising
+ * a new texture for every string. Each font is opened once per point size.
+ * Its glyphs are rendered in white the first time they are needed, packed
+ * into atlas pages, and tinted to the text colour when drawn. Strings are
+ * laid out once into quads, which are kept in an LRU cache and drawn
+ * through a SpriteBatch.
+ * Once the glyphs and layouts a screen uses are cached, drawing it neither
+ * touches FreeType nor creates textures.
+ */
+class TextRenderer {
+public:
+  static constexpr int pageSize = 512;
+
+  // Memory the cached layouts may take before the least recently drawn
+  // are dropped
+  static constexpr std::size_t defaultLayoutBudget = 1024 * 1024;
+
+  // One glyph placed relative to the top left of its text
+  struct Quad {
+    SDL_Texture *page;
+    SDL_FRect srcRect;
+    SDL_FRect destRect;
+    std::size_t index; // of the character it draws, counted in codepoints
+  };
+
+  // Quads are in the order of the characters they draw. Characters with
+  // nothing to draw (spaces, newlines) have no quad.
+  struct Layout {
+    std::vector<Quad> quads = {};
+    float width = 0;
+    float height = 0;
+    float lineHeight = 0;
+    std::size_t length = 0; // characters laid out
+  };
+
+  struct Stats {
+    std::size_t fonts = 0;
+    std::size_t pages = 0;
+    std::uint64_t glyphsRasterised = 0;
+    std::uint64_t layoutsBuilt = 0;
+  };
+
+  TextRenderer() : layouts(defaultLayoutBudget) {}
+  TextRenderer(const TextRenderer &) = delete;
+  TextRenderer &operator=(const TextRenderer &) = delete;
+  ~TextRenderer();
+
+  /*
+   * Lay text out in the given font, wrapping lines at whitespace so none is
+   * wider than wraplength pixels (0 to only break at newlines). Returns
+   * nullptr if the font can't be opened. Layouts are cached by font, size,
+   * wrap length and text; the one returned stays valid until the next call.
+   */
+  const Layout *layout(SDL_Renderer *renderer, const std::string &fontPath,
+                       float pointsize, std::string_view text, int wraplength);
+
+  /*
+   * Queue a layout's glyphs at position, in colour. Only glyphs of the
+   * first few characters are drawn if characters is given, which reveals
+   * text bit by bit without laying it out again, with every line already
+   * wrapped where it will be once the whole text shows.
+   */
+  static void draw(SpriteBatch &batch, const Layout &layout, SDL_FPoint position,
+                   SDL_Color colour, std::size_t characters = std::size_t(-1));
+
+  /*
+   * Close every font and destroy the glyph pages. Needed before TTF_Quit().
+   */
+  void clear();
+
+  const Stats &stats() const { return textStats; }
+
+  void setLayoutBudget(std::size_t bytes) { layouts.setBudget(bytes); }
+  const LruCache<std::string, Layout>::Stats &layoutStats() const {
+    return layouts.stats();
+  }
+
+private:
+  struct Glyph {
+    SDL_Texture *page = nullptr; // nullptr for glyphs with nothing to draw
+    SDL_FRect srcRect = {0, 0, 0, 0};
+    float offsetX = 0; // where the bitmap starts relative to the pen
+    float advance = 0;
+  };
+
+  struct Font {
+    TTF_Font *font = nullptr;
+    float lineSkip = 0;
+    float height = 0;
+    std::unordered_map<std::uint32_t, Glyph> glyphs = {};
+
+    // Pages glyphs are packed into, filled a shelf at a time
+    std::vector<SDL_Texture *> pages = {};
+    int shelfX = 0;
+    int shelfY = 0;
+    int shelfHeight = 0;
+  };
+
+  std::map<std::pair<std::string, float>, std::unique_ptr<Font>> fonts = {};
+  LruCache<std::string, Layout> layouts;
+  Stats textStats = {};
+
+  Font *openFont(const std::string &fontPath, float pointsize);
+  const Glyph &glyph(SDL_Renderer *renderer, Font &font,
+                     std::uint32_t codepoint);
+  bool packGlyph(SDL_Renderer *renderer, Font &font, SDL_Surface *surface,
+                 Glyph &glyph);
+  void buildLayout(SDL_Renderer *renderer, Font &font, std::string_view text,
+                   int wraplength, Layout &layout);
+};
@@ -0,0 +1,187 @@
+#include "TextureAtlas.h"
+#include "SDL3/SDL_log.h"
+#include "SDL3/SDL_surface.h"
+#include "SDL3_image/SDL_image.h"
+#include <algorithm>
+#include <numeric>
+#include <unordered_set>
+#include <utility>
+
+namespace {
+
+struct Shelf {
+  int y;
+  int height;
+  int used; // width taken so far
+};
+
+struct PageLayout {
+  std::vector<Shelf> shelves;
+  int width = 0;  // widest shelf
+  int height = 0; // bottom of the last shelf
+  int limit;      // page size, or the image size for oversized images
+};
+
+struct Placement {
+  std::size_t page;
+  int x, y;
+};
+
+/*
+ * Find room for a w x h block on a page: the existing shelf that wastes the
+ * least height, or a new shelf below the others
+ */
+bool placeOnPage(PageLayout &page, int w, int h, Placement &placement,
+                 std::size_t pageIndex) {
+  Shelf *best = nullptr;
+  for (Shelf &shelf : page.shelves) {
+    if (h <= shelf.height && shelf.used + w <= page.limit &&
+        (!best || shelf.height < best->height))
+      best = &shelf;
+  }
+
+  if (!best) {
+    if (page.height + h > page.limit || w > page.limit)
+      return false;
+    page.shelves.push_back({page.height, h, 0});
+    page.height += h;
+    best = &page.shelves.back();
+  }
+
+  placement = {pageIndex, best->used, best->y};
+  best->used += w;
+  page.width = std::max(page.width, best->used);
+  return true;
+}
+
+} // namespace
+
+TextureAtlas::TextureAtlas(TextureAtlas &&other) noexcept
+    : pages(std::move(other.pages)), regions(std::move(other.regions)) {
+  other.pages.clear();
+  other.regions.clear();
+}
+
+TextureAtlas &TextureAtlas::operator=(TextureAtlas &&other) noexcept {
+  if (this != &other) {
+    clear();
+    pages = std::move(other.pages);
+    regions = std::move(other.regions);
+    other.pages.clear();
+    other.regions.clear();
+  }
+  return *this;
+}
+
+bool TextureAtlas::build(SDL_Renderer *renderer,
+                         const std::vector<std::string> &imagePaths,
+                         int pageSize) {
+  clear();
+
+  // Load each distinct image once
+  std::vector<std::string> paths;
+  std::vector<SDL_Surface *> images;
+  std::unordered_set<std::string> seen;
+  for (const std::string &path : imagePaths) {
+    if (!seen.insert(path).second)
+      continue;
+    SDL_Surface *image = IMG_Load(path.c_str());
+    if (!image) {
+      SDL_Log("Atlas could not load %s: %s", path.c_str(), SDL_GetError());
+      continue;
+    }
+    paths.push_back(path);
+    images.push_back(image);
+  }
+
+  // Tallest first keeps shelves tightly filled
+  std::vector<std::size_t> order(images.size());
+  std::iota(order.begin(), order.end(), 0);
+  std::stable_sort(order.begin(), order.end(), [&](std::size_t a, std::size_t b) {
+    return images[a]->h > images[b]->h;
+  });
+
+  std::vector<PageLayout> layouts;
+  std::vector<Placement> placements(images.size());
+  for (std::size_t index : order) {
+    int w = images[index]->w + padding;
+    int h = images[index]->h + padding;
+
+    bool placed = false;
+    for (std::size_t page = 0; page < layouts.size() && !placed; page++)
+      placed = placeOnPage(layouts[page], w, h, placements[index], page);
+
+    if (!placed) {
+      PageLayout layout;
+      layout.limit = std::max({pageSize, w, h});
+      layouts.push_back(layout);
+      placeOnPage(layouts.back(), w, h, placements[index], layouts.size() - 1);
+    }
+  }
+
+  // Copy the images into page surfaces, trimmed to the space used, and
+  // upload each page once
+  bool ok = true;
+  std::vector<SDL_Surface *> surfaces;
+  for (const PageLayout &layout : layouts) {
+    SDL_Surface *surface =
+        SDL_CreateSurface(layout.width, layout.height, SDL_PIXELFORMAT_RGBA32);
+    if (!surface) {
+      SDL_Log("Atlas page could not be created: %s", SDL_GetError());
+      ok = false;
+    }
+    surfaces.push_back(surface);
+  }
+
+  for (std::size_t index = 0; index < images.size(); index++) {
+    const Placement &placement = placements[index];
+    SDL_Surface *surface = surfaces[placement.page];
+    if (surface) {
+      // Copy pixels as they are, alpha included, rather than blending
+      SDL_SetSurfaceBlendMode(images[index], SDL_BLENDMODE_NONE);
+      SDL_Rect dest = {placement.x, placement.y, images[index]->w,
+                       images[index]->h};
+      SDL_BlitSurface(images[index], nullptr, surface, &dest);
+    }
+  }
+
+  std::vector<SDL_Texture *> pageTextures(surfaces.size(), nullptr);
+  for (std::size_t page = 0; page < surfaces.size(); page++) {
+    if (!surfaces[page])
+      continue;
+    SDL_Texture *texture = SDL_CreateTextureFromSurface(renderer, surfaces[page]);
+    SDL_DestroySurface(surfaces[page]);
+    if (!texture) {
+      SDL_Log("Atlas page texture could not be created: %s", SDL_GetError());
+      ok = false;
+      continue;
+    }
+    SDL_SetTextureScaleMode(texture, SDL_SCALEMODE_NEAREST);
+    pageTextures[page] = texture;
+    pages.push_back(texture);
+  }
+
+  for (std::size_t index = 0; index < images.size(); index++) {
+    const Placement &placement = placements[index];
+    if (SDL_Texture *page = pageTextures[placement.page]) {
+      regions[paths[index]] = {
+          page, {float(placement.x), float(placement.y),
+                 float(images[index]->w), float(images[index]->h)}};
+    }
+    SDL_DestroySurface(images[index]);
+  }
+
+  return ok;
+}
+
+const AtlasRegion *TextureAtlas::find(const std::string &path) const {
+  auto found = regions.find(path);
+  return found != regions.end() ? &found->second : nullptr;
+}
+
+void TextureAtlas::clear() {
+  for (SDL_Texture *page : pages)
+    SDL_DestroyTexture(page);
+  pages.clear();
+  regions.clear();
+}
@@ -0,0 +1,67 @@
+#pragma once
+
+#include "SDL3/SDL_rect.h"
+#include "SDL3/SDL_render.h"
+#include <cstddef>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+/*
+ * Where an image ended up in an atlas
+ */
+struct AtlasRegion {
+  SDL_Texture *page;
+  SDL_FRect rect;
+};
+
+/*
+ * Packs many small images (e.g. the props of an object tileset) into one or
+ * a few large textures, so sprites drawn from them share a texture and batch
+ * together. Images are placed on shelves, tallest first; anything larger
+ * than a page gets a page of its own.
+ *
+ * Pages belong to the atlas: textures handed out by find() are destroyed by
+ * clear() and must not outlive it.
+ */
+class TextureAtlas {
+public:
+  static constexpr int defaultPageSize = 1024;
+
+  // Gap left between images, so neighbours never bleed into each other
+  static constexpr int padding = 1;
+
+  TextureAtlas() = default;
+  TextureAtlas(const TextureAtlas &) = delete;
+  TextureAtlas &operator=(const TextureAtlas &) = delete;
+  TextureAtlas(TextureAtlas &&other) noexcept;
+  TextureAtlas &operator=(TextureAtlas &&other) noexcept;
+  ~TextureAtlas() { clear(); }
+
+  /*
+   * Replace the atlas contents with the given images. Duplicate paths are
+   * packed once. Images that fail to load are logged and left out. Returns
+   * false if a page texture couldn't be created.
+   */
+  bool build(SDL_Renderer *renderer, const std::vector<std::string> &imagePaths,
+             int pageSize = defaultPageSize);
+
+  /*
+   * Return the page and rectangle holding the image loaded from path, or
+   * nullptr if it isn't in the atlas
+   */
+  const AtlasRegion *find(const std::string &path) const;
+
+  /*
+   * Destroy the pages and forget every image
+   */
+  void clear();
+
+  std::size_t pageCount() const { return pages.size(); }
+  std::size_t size() const { return regions.size(); }
+  bool empty() const { return regions.empty(); }
+
+private:
+  std::vector<SDL_Texture *> pages = {};
+  std::unordered_map<std::string, AtlasRegion> regions = {};
+};
@@ -0,0 +1,82 @@
+#include "TextureCache.h"
+#include "SDL3/SDL_log.h"
+#include "SDL3/SDL_pixels.h"
+#include "SDL3/SDL_surface.h"
+#include "SDL3_image/SDL_image.h"
+#include <cassert>
+
+SDL_Texture *TextureCache::acquire(SDL_Renderer *renderer,
+                                   const std::string &path) {
+  auto found = entries.find(path);
+  if (found != entries.end()) {
+    cacheStats.hits++;
+    found->second.references++;
+    return found->second.texture;
+  }
+
+  cacheStats.misses++;
+  SDL_Surface *surface = IMG_Load(path.c_str());
+  if (!surface) {
+    SDL_Log("Could not load texture %s: %s", path.c_str(), SDL_GetError());
+    return nullptr;
+  }
+  SDL_Texture *texture = SDL_CreateTextureFromSurface(renderer, surface);
+  SDL_DestroySurface(surface);
+  if (!texture) {
+    SDL_Log("Could not create texture %s: %s", path.c_str(), SDL_GetError());
+    return nullptr;
+  }
+  SDL_SetTextureScaleMode(texture, SDL_SCALEMODE_NEAREST);
+
+  std::size_t bytes = std::size_t(texture->w) * std::size_t(texture->h) *
+                      SDL_BYTESPERPIXEL(texture->format);
+  entries[path] = {texture, 1, bytes};
+  paths[texture] = path;
+  cacheStats.textures++;
+  cacheStats.bytesResident += bytes;
+  return texture;
+}
+
+void TextureCache::release(SDL_Texture *texture) {
+  auto path = paths.find(texture);
+  if (path == paths.end())
+    return;
+
+  Entry &entry = entries.at(path->second);
+  assert(entry.references > 0 && "Texture released more often than acquired!");
+  if (entry.references > 0)
+    entry.references--;
+}
+
+std::size_t TextureCache::evictUnused() {
+  std::size_t evicted = 0;
+  for (auto entry = entries.begin(); entry != entries.end();) {
+    if (entry->second.references == 0) {
+      destroy(entry++);
+      evicted++;
+    } else {
+      ++entry;
+    }
+  }
+  return evicted;
+}
+
+void TextureCache::clear() {
+  while (!entries.empty())
+    destroy(entries.begin());
+}
+
+int TextureCache::references(const std::string &path) const {
+  auto found = entries.find(path);
+  return found != entries.end() ? found->second.references : 0;
+}
+
+void TextureCache::destroy(
+    std::unordered_map<std::string, Entry>::iterator entry) {
+  SDL_DestroyTexture(entry->second.texture);
+  paths.erase(entry->second.texture);
+  cacheStats.evictions++;
+  cacheStats.textures--;
+  cacheStats.bytesResident -= entry->second.bytes;
+  entries.erase(entry);
+}
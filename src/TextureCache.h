@@ -0,0 +1,71 @@
+#pragma once
+
+#include "SDL3/SDL_render.h"
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <unordered_map>
+
+/*
+ * Textures loaded from image files, shared by everything that uses the same
+ * file. acquire() hands out the cached texture and counts a reference;
+ * release() gives it back. A texture nobody references stays loaded, so the
+ * next map or panel that wants it doesn't decode it again, until
+ * evictUnused() or clear() is called.
+ */
+class TextureCache {
+public:
+  struct Stats {
+    std::uint64_t hits = 0;
+    std::uint64_t misses = 0;
+    std::uint64_t evictions = 0;
+    std::size_t textures = 0;      // loaded right now
+    std::size_t bytesResident = 0; // estimated from size and pixel format
+  };
+
+  TextureCache() = default;
+  TextureCache(const TextureCache &) = delete;
+  TextureCache &operator=(const TextureCache &) = delete;
+  ~TextureCache() { clear(); }
+
+  /*
+   * Return the texture for the image at path, loading it on first use, and
+   * add a reference to it. Returns nullptr if the image can't be loaded.
+   */
+  SDL_Texture *acquire(SDL_Renderer *renderer, const std::string &path);
+
+  /*
+   * Drop a reference taken by acquire(). Textures the cache doesn't know
+   * (nullptr, or already evicted by clear()) are ignored.
+   */
+  void release(SDL_Texture *texture);
+
+  /*
+   * Destroy every texture with no references left and return how many went
+   */
+  std::size_t evictUnused();
+
+  /*
+   * Destroy every texture, referenced or not. Only for shutdown, before the
+   * renderer goes.
+   */
+  void clear();
+
+  // Number of references held on the texture loaded from path
+  int references(const std::string &path) const;
+
+  const Stats &stats() const { return cacheStats; }
+
+private:
+  struct Entry {
+    SDL_Texture *texture;
+    int references;
+    std::size_t bytes;
+  };
+
+  std::unordered_map<std::string, Entry> entries = {};
+  std::unordered_map<SDL_Texture *, std::string> paths = {};
+  Stats cacheStats = {};
+
+  void destroy(std::unordered_map<std::string, Entry>::iterator entry);
+};
@@ -6,6 +6,7 @@
 #include "SDL3/SDL_render.h"
 #include "SDL3_image/SDL_image.h"
 #include "SDL3_ttf/SDL_ttf.h"
+#include <cmath>
 
 fs::path TextureManager::fontPath = fs::path(SDL_GetBasePath()) / "assets" /
                                     "fonts" / "AtlantisInternational-jen0.ttf";
@@ -19,12 +20,60 @@ SDL_Texture *TextureManager::LoadTexture(const char *filePath) {
   return tex;
 }
 
+TextureCache TextureManager::cache;
+TextRenderer TextureManager::textRenderer;
+std::unordered_map<SDL_Texture *, Size> TextureManager::messageSizes;
+TextureManager::MessageCache TextureManager::messageCache(
+    defaultMessageCacheBudget, [](CachedMessage &message) {
+      messageSizes.erase(message.tex);
+      SDL_DestroyTexture(message.tex);
+    });
+
+SDL_Texture *TextureManager::AcquireTexture(const std::string &filePath) {
+  return cache.acquire(Engine::renderer, filePath);
+}
+
+void TextureManager::ReleaseTexture(SDL_Texture *tex) { cache.release(tex); }
+
+std::size_t TextureManager::EvictUnusedTextures() {
+  return cache.evictUnused();
+}
+
+void TextureManager::ClearTextureCache() { cache.clear(); }
+
+SpriteBatch TextureManager::batch;
+bool TextureManager::batching = false;
+const TextureAtlas *TextureManager::atlas = nullptr;
+
+const AtlasRegion *TextureManager::GetAtlasRegion(const std::string &filePath) {
+  return atlas ? atlas->find(filePath) : nullptr;
+}
+
 void TextureManager::Draw(SDL_Texture *tex, SDL_FRect srcRect,
                           SDL_FRect destRect, SDL_FlipMode flip) {
+  if (batching) {
+    batch.draw(tex, srcRect, destRect, flip);
+    return;
+  }
   SDL_RenderTextureRotated(Engine::renderer, tex, &srcRect,
                            &destRect, NULL, NULL, flip);
 }
 
+void TextureManager::BeginBatch() {
+  FlushBatch();
+  batching = true;
+}
+
+void TextureManager::EndBatch() {
+  FlushBatch();
+  batching = false;
+}
+
+void TextureManager::FlushBatch() {
+  if (!batch.empty())
+    batch.flush(Engine::renderer);
+}
+
 SDL_Texture *TextureManager::LoadMessageTexture(const std::string_view text,
                                                 float pointsize, int wraplength,
                                                 SDL_Color colour) {
@@ -52,7 +101,29 @@ SDL_Texture *TextureManager::LoadMessageTexture(const std::string_view text,
   return messageTex;
 }
 
+SDL_Texture *TextureManager::GetMessageTexture(const std::string_view text,
+                                               float pointsize, int wraplength,
+                                               SDL_Color colour) {
+  MessageKey key = {std::string(text), pointsize, wraplength, colour};
+  if (CachedMessage *cached = messageCache.find(key))
+    return cached->tex;
+
+  SDL_Texture *messageTex =
+      LoadMessageTexture(text, pointsize, wraplength, colour);
+  if (!messageTex)
+    return nullptr;
+
+  // Textures queued in the batch may be about to be evicted
+  FlushBatch();
+  Size size = {float(messageTex->w), float(messageTex->h)};
+  std::size_t bytes = std::size_t(messageTex->w) * std::size_t(messageTex->h) *
+                      SDL_BYTESPERPIXEL(messageTex->format);
+  messageSizes[messageTex] = size;
+  return messageCache.insert(std::move(key), {messageTex, size}, bytes).tex;
+}
+
 void TextureManager::DrawRect(SDL_FRect rect, SDL_Color colour) {
+  FlushBatch();
   SDL_SetRenderDrawColor(Engine::renderer, colour.r, colour.g, colour.b,
                          SDL_ALPHA_OPAQUE);
   SDL_RenderRect(Engine::renderer, &rect);
@@ -67,23 +138,89 @@ void TextureManager::DrawPanel(SDL_FRect borderRect, SDL_FRect innerRect,
 
 void TextureManager::DrawText(TextProperties textProps,
                               SDL_FRect const &containerRect) {
-
-  SDL_Texture *textTex = TextureManager::LoadMessageTexture(
-      textProps.text, textProps.pointsize, textProps.wraplength,
-      textProps.colour);
-  Size textDims = TextureManager::GetMessageTextureDimensions(textTex);
+  // Laid out from cached glyphs; nothing is rasterised once the text has
+  // been drawn before
+  const TextRenderer::Layout *layout =
+      textRenderer.layout(Engine::renderer, fontPath.string(),
+                          textProps.pointsize, textProps.text,
+                          textProps.wraplength);
+  if (!layout)
+    return;
 
   // Render button text
-  SDL_FRect textRect = {0, 0, textDims.width, textDims.height};
+  SDL_FRect textRect = {0, 0, layout->width, layout->height};
   UIHelper::alignRelativeToContainer(textRect, containerRect,
                                      textProps.horizontalAlign,
                                      textProps.verticalAlign);
   textRect.y = textRect.y + textProps.margin.top - textProps.margin.bottom;
   textRect.x = textRect.x + textProps.margin.left - textProps.margin.right;
-  SDL_RenderTexture(Engine::renderer, textTex, NULL, &textRect);
 
-  // Cleanup
-  SDL_DestroyTexture(textTex);
+  // Each glyph page the text uses is one draw call; outside a batch the
+  // quads are submitted straight away
+  TextRenderer::draw(batch, *layout, {textRect.x, textRect.y},
+                     textProps.colour);
+  if (!batching)
+    FlushBatch();
+}
+
+const TextRenderer::Layout *TextureManager::LayoutText(std::string_view text,
+                                                      float pointsize,
+                                                      int wraplength) {
+  return textRenderer.layout(Engine::renderer, fontPath.string(), pointsize,
+                             text, wraplength);
+}
+
+void TextureManager::DrawTextLayout(const TextRenderer::Layout &layout,
+                                    SDL_FPoint position, SDL_Color colour,
+                                    std::size_t characters,
+                                    const SDL_FRect *clipRect) {
+  // The clip rectangle applies to whatever is submitted while it is set
+  FlushBatch();
+  SDL_Rect previousClip = {0, 0, 0, 0};
+  bool clipped = SDL_RenderClipEnabled(Engine::renderer);
+  if (clipped)
+    SDL_GetRenderClipRect(Engine::renderer, &previousClip);
+
+  if (clipRect) {
+    SDL_Rect clip = {int(std::floor(clipRect->x)), int(std::floor(clipRect->y)),
+                     int(std::ceil(clipRect->w)), int(std::ceil(clipRect->h))};
+    // Stay inside any clip the caller had set
+    if (clipped && !SDL_GetRectIntersection(&clip, &previousClip, &clip))
+      return;
+    SDL_SetRenderClipRect(Engine::renderer, &clip);
+  }
+
+  TextRenderer::draw(batch, layout, position, colour, characters);
+  FlushBatch();
+
+  if (clipRect)
+    SDL_SetRenderClipRect(Engine::renderer, clipped ? &previousClip : nullptr);
+}
+
+void TextureManager::ClearTextCache() {
+  FlushBatch();
+  messageCache.clear();
+  textRenderer.clear();
+}
+
+void TextureManager::SetMessageCacheBudget(std::size_t bytes) {
+  // Textures evicted now may still be queued
+  FlushBatch();
+  messageCache.setBudget(bytes);
+}
+
+const TextureManager::MessageCache::Stats &
+TextureManager::GetMessageCacheStats() {
+  return messageCache.stats();
+}
+
+void TextureManager::SetTextLayoutBudget(std::size_t bytes) {
+  textRenderer.setLayoutBudget(bytes);
+}
+
+const TextureManager::LayoutCache::Stats &
+TextureManager::GetTextLayoutStats() {
+  return textRenderer.layoutStats();
 }
 
 SDL_FRect TextureManager::DrawButton(ButtonProperties buttonProps,
@@ -110,6 +247,10 @@ SDL_FRect TextureManager::DrawButton(ButtonProperties buttonProps,
 Size TextureManager::GetMessageTextureDimensions(SDL_Texture *messageTex) {
   assert(messageTex != nullptr && "Message texture does not exist!");
 
+  auto cached = messageSizes.find(messageTex);
+  if (cached != messageSizes.end())
+    return cached->second;
+
   auto texprops = SDL_GetTextureProperties(messageTex);
   float textWidth =
       float(SDL_GetNumberProperty(texprops, SDL_PROP_TEXTURE_WIDTH_NUMBER, 0));
@@ -1,11 +1,21 @@
 #pragma once
 
 #include "Constants.h"
+#include "LruCache.h"
 #include "SDL3/SDL_pixels.h"
 #include "SDL3/SDL_rect.h"
 #include "SDL3/SDL_render.h"
+#include "SpriteBatch.h"
+#include "TextureAtlas.h"
+#include "TextureCache.h"
+#include "TextRenderer.h"
 #include "UI/UIHelper.h"
+#include <cstddef>
 #include <filesystem>
+#include <functional>
+#include <string>
+#include <string_view>
+#include <unordered_map>
 
 namespace fs = std::filesystem;
 
@@ -44,16 +54,65 @@ class TextureManager {
 public:
   static fs::path fontPath;
 
+  // Load a texture the caller owns and destroys
   static SDL_Texture *LoadTexture(const char *filePath);
 
+  // Shared texture for an image file, loaded once however many things use
+  // it. Every AcquireTexture() needs a matching ReleaseTexture(); textures
+  // nothing uses any more stay cached until EvictUnusedTextures().
+  static SDL_Texture *AcquireTexture(const std::string &filePath);
+  static void ReleaseTexture(SDL_Texture *tex);
+  static std::size_t EvictUnusedTextures();
+
+  // Destroy every cached texture. Called on shutdown, before the renderer
+  // is destroyed.
+  static void ClearTextureCache();
+
+  static const TextureCache &GetTextureCache() { return cache; }
+
   static void Draw(SDL_Texture *tex, SDL_FRect srcRect, SDL_FRect destRect,
                    SDL_FlipMode flip);
 
+  // Between BeginBatch() and EndBatch(), Draw() queues quads which are
+  // submitted a texture run at a time with SDL_RenderGeometry. Anything drawn
+  // another way in between must call FlushBatch() first to keep the order;
+  // the other Draw* functions here do this themselves.
+  static void BeginBatch();
+  static void EndBatch();
+  static void FlushBatch();
+
+  static const SpriteBatch &GetBatch() { return batch; }
+
+  // Atlas consulted by sprites before loading a texture of their own. The
+  // atlas must outlive every sprite created while it is set.
+  static void SetAtlas(const TextureAtlas *textureAtlas) {
+    atlas = textureAtlas;
+  }
+
+  // Region of the current atlas holding the image at filePath, or nullptr
+  static const AtlasRegion *GetAtlasRegion(const std::string &filePath);
+
+  // Glyph-cached text used by DrawText, and the cached message textures.
+  // Fonts are closed and every text texture destroyed by ClearTextCache(),
+  // which must happen before TTF_Quit().
+  static const TextRenderer &GetTextRenderer() { return textRenderer; }
+  static void ClearTextCache();
+
+  // Render text to a new texture the caller owns and destroys
   static SDL_Texture *LoadMessageTexture(const std::string_view text,
                                          float pointsize,
                                          int wraplength = SCREEN_WIDTH,
                                          SDL_Color colour = {0, 0, 0});
 
+  // Same as LoadMessageTexture, but memoised: the same text in the same
+  // style gives back the texture rendered last time. The cache owns it, so
+  // don't destroy it, and draw it before asking for text that isn't cached,
+  // as making room for that may evict it.
+  static SDL_Texture *GetMessageTexture(const std::string_view text,
+                                        float pointsize,
+                                        int wraplength = SCREEN_WIDTH,
+                                        SDL_Color colour = {0, 0, 0});
+
   static void DrawRect(SDL_FRect rect, SDL_Color colour);
 
   static void DrawPanel(SDL_FRect borderRect, SDL_FRect innerRect,
@@ -62,10 +121,85 @@ public:
   static void DrawText(TextProperties textProps,
                        SDL_FRect const &containerRect);
 
+  // Lay text out without drawing it. The layout is only valid until text is
+  // next laid out or drawn, so copy it to keep it.
+  static const TextRenderer::Layout *LayoutText(std::string_view text,
+                                                float pointsize,
+                                                int wraplength = SCREEN_WIDTH);
+
+  // Draw the first characters of a layout with its top left at position,
+  // clipped to clipRect if one is given. The renderer's clip rect is left as
+  // it was.
+  static void DrawTextLayout(const TextRenderer::Layout &layout,
+                             SDL_FPoint position, SDL_Color colour,
+                             std::size_t characters = std::size_t(-1),
+                             const SDL_FRect *clipRect = nullptr);
+
   // Draw correctly spaced button and return the drawn button rectangle
   static SDL_FRect DrawButton(ButtonProperties buttonProps,
                               SDL_FRect const &containerRect,
                               float buttonSpacing);
 
   static Size GetMessageTextureDimensions(SDL_Texture *messageTex);
+
+  // Text style and content a message texture was rendered from
+  struct MessageKey {
+    std::string text;
+    float pointsize;
+    int wraplength;
+    SDL_Color colour;
+
+    bool operator==(const MessageKey &other) const {
+      return text == other.text && pointsize == other.pointsize &&
+             wraplength == other.wraplength &&
+             colour.r == other.colour.r && colour.g == other.colour.g &&
+             colour.b == other.colour.b && colour.a == other.colour.a;
+    }
+  };
+
+  struct MessageKeyHash {
+    std::size_t operator()(const MessageKey &key) const {
+      std::size_t hash = std::hash<std::string>()(key.text);
+      auto combine = [&hash](std::size_t value) {
+        hash ^= value + 0x9e3779b97f4a7c15ull + (hash << 6) + (hash >> 2);
+      };
+      combine(std::hash<float>()(key.pointsize));
+      combine(std::hash<int>()(key.wraplength));
+      combine(std::size_t(key.colour.r) | std::size_t(key.colour.g) << 8 |
+              std::size_t(key.colour.b) << 16 |
+              std::size_t(key.colour.a) << 24);
+      return hash;
+    }
+  };
+
+  struct CachedMessage {
+    SDL_Texture *tex;
+    Size size;
+  };
+
+  using MessageCache = LruCache<MessageKey, CachedMessage, MessageKeyHash>;
+  using LayoutCache = LruCache<std::string, TextRenderer::Layout>;
+
+  // Memory the cached message textures may take before the least recently
+  // used are destroyed, and how well the cache is doing at its budget
+  static void SetMessageCacheBudget(std::size_t bytes);
+  static const MessageCache::Stats &GetMessageCacheStats();
+
+  // Same for the text layouts DrawText() and LayoutText() keep. Layouts are
+  // only quads, so the same budget holds many more of them than textures.
+  static void SetTextLayoutBudget(std::size_t bytes);
+  static const LayoutCache::Stats &GetTextLayoutStats();
+
+private:
+  static SpriteBatch batch;
+  static bool batching;
+  static const TextureAtlas *atlas;
+  static TextureCache cache;
+  static TextRenderer textRenderer;
+
+  static constexpr std::size_t defaultMessageCacheBudget = 2 * 1024 * 1024;
+  static MessageCache messageCache;
+
+  // Sizes of the cached message textures, so measuring one is a lookup
+  static std::unordered_map<SDL_Texture *, Size> messageSizes;
 };
@@ -13,6 +13,7 @@
 #include <algorithm>
 #include <sstream>
 #include <string>
+#include <vector>
 
 class DialoguePanel : public IUIComponent {
 public:
@@ -32,33 +33,26 @@ public:
 
   void render(SDL_Renderer *renderer, SDL_Window *window) override {
     if (show) {
-      TextureManager::DrawPanel(borderRect, innerRect, borderColour,
-                                innerColour);
-
       // Keeps offset within bounds so that we keep text visible
       if (!finishedWriting) {
         // Set max scroll offset if we haven't finished writing
-        scrollOffset = messageDims.height - textRect.h;
+        scrollOffset = writtenHeight - textRect.h;
       } else {
         scrollOffset = std::max(scrollOffset, 0.0f);
-        scrollOffset = std::min(scrollOffset, messageDims.height - textRect.h);
+        scrollOffset = std::min(scrollOffset, writtenHeight - textRect.h);
       }
 
-      // source rect used to clip the text based on offset
-      SDL_FRect dest;
-      SDL_FRect src;
-
-      if (messageDims.height > textRect.h) {
-        // scrolling is needed in this case
-        src = {0, scrollOffset, textRect.w, textRect.h};
-        dest = {textRect.x, textRect.y, textRect.w, textRect.h};
-      } else {
-        // message fits in window -- no scrolling
-        src = {0, 0, textRect.w, textRect.h};
-        dest = {textRect.x, textRect.y, messageDims.width, messageDims.height};
-      }
-
-      SDL_RenderTexture(renderer, messageTex, &src, &dest);
+      renderRetained(renderer, borderRect, [&]() {
+        TextureManager::DrawPanel(borderRect, innerRect, borderColour,
+                                  innerColour);
+
+        // Scroll only once the text is taller than the window, and clip
+        // whatever is scrolled out of it
+        float offset = writtenHeight > textRect.h ? scrollOffset : 0.0f;
+        TextureManager::DrawTextLayout(messageLayout,
+                                       {textRect.x, textRect.y - offset},
+                                       fontColour, messageIdx, &textRect);
+      });
     }
   }
 
@@ -90,29 +84,42 @@ public:
         // Reset scrolling
         scrollOffset = 0;
 
+        // Lay the whole message out once, so it wraps where it will end
+        // up from the first character. The typewriter effect then only
+        // changes how many characters are drawn.
+        const TextRenderer::Layout *layout = TextureManager::LayoutText(
+            message, pointsize, static_cast<int>(textRect.w));
+        messageLayout = layout ? *layout : TextRenderer::Layout{};
+
         // Reset var for typewriter effect
         messageIdx = 0;
+        revealedQuads = 0;
+        writtenHeight = 0;
         finishedWriting = false;
       }
 
       if (!finishedWriting) {
         // Display only characters we are up to for typewriter effect
         messageIdx++;
-        std::string currMessage = message.substr(0, messageIdx);
+        markDirty();
 
         // Play dialogue sound every fifth character
-        if (currMessage.size() % 5 == 0)
+        if (messageIdx % 5 == 0)
           Mix_PlayChannel(-1, dialogueSound, 0);
 
-        // Recreate texture
-        SDL_DestroyTexture(messageTex);
-        messageTex = TextureManager::LoadMessageTexture(
-            currMessage, pointsize, static_cast<int>(textRect.w), fontColour);
-        messageDims = TextureManager::GetMessageTextureDimensions(messageTex);
+        // Grow the written height as new lines are reached
+        const std::vector<TextRenderer::Quad> &quads = messageLayout.quads;
+        while (revealedQuads < quads.size() &&
+               quads[revealedQuads].index < messageIdx)
+          revealedQuads++;
+        if (revealedQuads > 0)
+          writtenHeight = quads[revealedQuads - 1].destRect.y +
+                          messageLayout.lineHeight;
 
         // Check if we've finished
-        if (messageIdx == message.size()) {
+        if (messageIdx >= messageLayout.length) {
           finishedWriting = true;
+          writtenHeight = messageLayout.height;
           dialogue->canRespond = true;
         }
       }
@@ -123,6 +130,7 @@ public:
   void handleEvents(const SDL_Event &event, const MouseInfo &mouseInfo) override {
     // Handle panel scrolling
     if (show && finishedWriting) {
+      float previousOffset = scrollOffset;
       if (event.type == SDL_EVENT_KEY_DOWN) {
         switch (event.key.key) {
         case SDLK_S: // scroll down
@@ -140,10 +148,15 @@ public:
         if (Collision::AABB(borderRect, mousePos))
           scrollOffset -= (scrollAmount * event.wheel.y);
       }
+      if (scrollOffset != previousOffset)
+        markDirty();
     }
   }
 
-  void clean() override { SDL_DestroyTexture(messageTex); }
+  void clean() override {
+    messageLayout = {};
+    markDirty();
+  }
 
 private:
   bool show = false;
@@ -157,8 +170,10 @@ private:
   SDL_Color fontColour;
   float pointsize;
 
-  SDL_Texture *messageTex;
-  Size messageDims;
+  // Glyphs of the whole message. Copied, as the text cache may drop its
+  // own layout while the message is on screen.
+  TextRenderer::Layout messageLayout;
+  float writtenHeight = 0; // height of the text written so far
   std::string line;    // current line
   std::string message; // message to print
 
@@ -166,7 +181,8 @@ private:
   float const scrollAmount = 5.0f;
 
   // for typewriter effect
-  int messageIdx = 0; // which letter of the message we are up to
+  std::size_t messageIdx = 0;    // which letter of the message we are up to
+  std::size_t revealedQuads = 0; // glyphs of those letters
   bool finishedWriting = false;
 
   // for dialogue sounds
@@ -31,42 +31,8 @@ public:
   ~DialogueResponsePanel() { clean(); }
 
   void render(SDL_Renderer *renderer, SDL_Window *window) override {
-    float yOffset = -scrollOffset;
-    if (show) {
-      TextureManager::DrawPanel(borderRect, innerRect, borderColour,
-                                innerColour);
-
-      for (int idx = 0; idx < responseTextures.size(); idx++) {
-
-        ResponseTexture &curLine = responseTextures[idx];
-        curLine.displayed = false;
-
-        SDL_Texture *tex = nullptr;
-        if (idx == selectedResponse)
-          tex = curLine.activeTex;
-        else
-          tex = curLine.inactiveTex;
-
-        SDL_FRect dest = {textRect.x, textRect.y + yOffset, curLine.width,
-                          curLine.height};
-
-        if (yOffset + textRect.y < textRect.y) {
-          // Skip lines above view area
-          yOffset += curLine.height;
-          continue;
-        }
-
-        if (yOffset + textRect.y + curLine.height > textRect.y + textRect.h) {
-          // Stop rendering if lines below view area
-          break;
-        }
-
-        curLine.displayed = true;
-        SDL_RenderTexture(renderer, tex, NULL, &dest);
-
-        yOffset += curLine.height;
-      }
-    }
+    if (show)
+      renderRetained(renderer, borderRect, [&]() { drawResponses(renderer); });
   }
 
   void update(Interactable *interactable, Dialogue *dialogue) override {
@@ -122,6 +88,21 @@ public:
   }
 
   void handleEvents(const SDL_Event &event, const MouseInfo &mouseInfo) override {
+    int previousSelection = selectedResponse;
+    float previousOffset = scrollOffset;
+    handleSelection(event, mouseInfo);
+    if (selectedResponse != previousSelection || scrollOffset != previousOffset)
+      markDirty();
+  }
+
+  // The textures belong to TextureManager's text cache
+  void clean() override {
+    responseTextures.clear();
+    markDirty();
+  }
+
+private:
+  void handleSelection(const SDL_Event &event, const MouseInfo &mouseInfo) {
     // Dialogue selection events for keyboard
     if (state != INACTIVE && event.type == SDL_EVENT_KEY_DOWN) {
       switch (event.key.key) {
@@ -221,21 +202,6 @@ public:
     }
   }
 
-  void clean() override {
-    for (auto &responseTexture : responseTextures) {
-      if (responseTexture.activeTex) {
-        SDL_DestroyTexture(responseTexture.activeTex);
-        responseTexture.activeTex = nullptr;
-      }
-      if (responseTexture.inactiveTex) {
-        SDL_DestroyTexture(responseTexture.inactiveTex);
-        responseTexture.inactiveTex = nullptr;
-      }
-    }
-    responseTextures.clear();
-  }
-
-private:
   bool show = false;
 
   enum DialogueState { INACTIVE, ACTIVE, PROGRESS, END };
@@ -256,8 +222,7 @@ private:
   int nextNodeId = 0;
 
   struct ResponseTexture {
-    SDL_Texture *activeTex;
-    SDL_Texture *inactiveTex;
+    std::string message;
     bool displayed;
     float height;
     float width;
@@ -266,9 +231,46 @@ private:
   std::vector<ResponseTexture> responseTextures;
 
   // variables for scroll offsetting
-  float scrollOffset;
+  float scrollOffset = 0.0f;
   enum Direction { UP, DOWN };
 
+  void drawResponses(SDL_Renderer *renderer) {
+    TextureManager::DrawPanel(borderRect, innerRect, borderColour,
+                              innerColour);
+
+    float yOffset = -scrollOffset;
+    for (int idx = 0; idx < responseTextures.size(); idx++) {
+
+      ResponseTexture &curLine = responseTextures[idx];
+      curLine.displayed = false;
+
+      SDL_FRect dest = {textRect.x, textRect.y + yOffset, curLine.width,
+                        curLine.height};
+
+      if (yOffset + textRect.y < textRect.y) {
+        // Skip lines above view area
+        yOffset += curLine.height;
+        continue;
+      }
+
+      if (yOffset + textRect.y + curLine.height > textRect.y + textRect.h) {
+        // Stop rendering if lines below view area
+        break;
+      }
+
+      curLine.displayed = true;
+
+      // Both colours of every line stay in the text cache, so changing
+      // the selection doesn't render anything
+      SDL_Color colour = idx == selectedResponse ? selectColour : fontColour;
+      SDL_Texture *tex = TextureManager::GetMessageTexture(
+          curLine.message, pointsize, static_cast<int>(textRect.w), colour);
+      SDL_RenderTexture(renderer, tex, NULL, &dest);
+
+      yOffset += curLine.height;
+    }
+  }
+
   int getNextNode() {
     for (int idx = 0; idx < responses.size(); idx++) {
       if (idx == selectedResponse)
@@ -289,16 +291,16 @@ private:
       ss << idx + 1 << ". " << line << std::endl;
       std::string message = ss.str();
 
-      rtex.activeTex = TextureManager::LoadMessageTexture(
-          static_cast<std::string_view>(message), pointsize,
-          static_cast<int>(textRect.w), selectColour);
-
-      rtex.inactiveTex = TextureManager::LoadMessageTexture(
+      // Only measured here; render() fetches the texture in whichever
+      // colour it needs from the text cache
+      SDL_Texture *messageTex = TextureManager::GetMessageTexture(
           static_cast<std::string_view>(message), pointsize,
           static_cast<int>(textRect.w), fontColour);
+      Size messageDims =
+          messageTex ? TextureManager::GetMessageTextureDimensions(messageTex)
+                     : Size{0, 0};
 
-      auto messageDims =
-          TextureManager::GetMessageTextureDimensions(rtex.activeTex);
+      rtex.message = message;
 
       rtex.height = messageDims.height;
       rtex.width = messageDims.width;
@@ -307,6 +309,7 @@ private:
 
       responseTextures.push_back(rtex);
     }
+    markDirty();
   }
 
   void setScrollOffset(Direction dir) {
@@ -24,14 +24,26 @@ public:
   }
 
   void handleEvents(const SDL_Event &e, const MouseInfo &m) {
+    // Cached panel textures lose their contents along with the other
+    // render targets
+    bool targetsLost = e.type == SDL_EVENT_RENDER_TARGETS_RESET;
     for (auto &child : children) {
+      if (targetsLost)
+        child->markDirty();
       child->handleEvents(e, m);
     }
   }
 
+  void setRetained(bool enable) {
+    for (auto &child : children) {
+      child->setRetained(enable);
+    }
+  }
+
   void clean() {
     for (auto &child : children) {
       child->clean();
+      child->releaseRetained();
     }
   }
 
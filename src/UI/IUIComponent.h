@@ -3,7 +3,10 @@
 #include "../Components/Dialogue.h"
 #include "../Components/Interactable.h"
 #include "../Components/MouseController.h"
+#include "../Constants.h"
+#include "../TextureManager.h"
 #include "SDL3/SDL_events.h"
+#include "SDL3/SDL_log.h"
 #include "SDL3/SDL_render.h"
 
 class IUIComponent {
@@ -13,4 +16,92 @@ public:
   virtual void render(SDL_Renderer *renderer, SDL_Window *window) {}
   virtual void handleEvents(const SDL_Event &event, const MouseInfo &mouseInfo) {}
   virtual void clean() {}
+
+  /*
+   * Retained mode. Components that draw through renderRetained() keep what
+   * they drew in a texture of their own, and only draw again after
+   * markDirty(); every other frame is one copy of that texture. Off by
+   * default, in which case they draw every frame as usual.
+   */
+  void setRetained(bool enable) {
+    if (!enable)
+      releaseRetained();
+    retained = enable;
+    dirty = true;
+  }
+
+  bool isRetained() const { return retained; }
+
+  // Call whenever something the component shows changes
+  void markDirty() { dirty = true; }
+
+  // Destroy the cached texture; it is made again when next needed
+  void releaseRetained() {
+    if (target)
+      SDL_DestroyTexture(target);
+    target = nullptr;
+    dirty = true;
+  }
+
+protected:
+  /*
+   * Draw the component with draw(), or in retained mode copy bounds from
+   * what draw() left in the cached texture last time. draw() keeps using
+   * screen coordinates: the texture covers the whole logical screen, and
+   * only the part inside bounds is shown.
+   */
+  template<typename DrawFunc>
+  void renderRetained(SDL_Renderer *renderer, const SDL_FRect &bounds,
+                      DrawFunc draw) {
+    if (!retained) {
+      draw();
+      return;
+    }
+
+    if (!target) {
+      target = SDL_CreateTexture(renderer, SDL_PIXELFORMAT_RGBA8888,
+                                 SDL_TEXTUREACCESS_TARGET, SCREEN_WIDTH,
+                                 SCREEN_HEIGHT);
+      if (!target) {
+        SDL_Log("UI render target unavailable, drawing directly: %s",
+                SDL_GetError());
+        retained = false;
+        draw();
+        return;
+      }
+      SDL_SetTextureBlendMode(target, SDL_BLENDMODE_BLEND);
+      SDL_SetTextureScaleMode(target, SDL_SCALEMODE_NEAREST);
+      dirty = true;
+    }
+
+    // Anything already queued belongs to the current target
+    TextureManager::FlushBatch();
+
+    bool moved = bounds.x != lastBounds.x || bounds.y != lastBounds.y ||
+                 bounds.w != lastBounds.w || bounds.h != lastBounds.h;
+    if (dirty || moved) {
+      SDL_Texture *previousTarget = SDL_GetRenderTarget(renderer);
+      Uint8 r, g, b, a;
+      SDL_GetRenderDrawColor(renderer, &r, &g, &b, &a);
+
+      SDL_SetRenderTarget(renderer, target);
+      SDL_SetRenderDrawColor(renderer, 0, 0, 0, SDL_ALPHA_TRANSPARENT);
+      SDL_RenderClear(renderer);
+      draw();
+      TextureManager::FlushBatch();
+
+      SDL_SetRenderTarget(renderer, previousTarget);
+      SDL_SetRenderDrawColor(renderer, r, g, b, a);
+      lastBounds = bounds;
+      dirty = false;
+    }
+
+    SDL_RenderTexture(renderer, target, &bounds, &bounds);
+  }
+
+private:
+  bool retained = false;
+  bool dirty = true;
+  SDL_Texture *target = nullptr;
+  SDL_FRect lastBounds = {0, 0, 0, 0};
 };
@@ -30,7 +30,7 @@ public:
         innerColour(innerColour), buttonColour(buttonColour) {
 
     // Load any textures
-    selectIconTex = TextureManager::LoadTexture(selectIconPath.string().c_str());
+    selectIconTex = TextureManager::AcquireTexture(selectIconPath.string());
 
     std::unordered_map<std::string, MenuItem> mainMenuItems = {
       {"Graphics", {}},
@@ -171,8 +171,225 @@ public:
     if (itemSet) {
       itemSet->selectItem(renderer, window);
       itemSet = nullptr; // Release pointer
+      markDirty();
     }
 
+    if (!show || !activeMenu)
+      return;
+
+    // The menu is only drawn again when it changes
+    const SDL_FRect &menuRect =
+        activeMenu->menuType == MenuType::Main       ? mainMenuRect
+        : activeMenu->menuType == MenuType::Settings ? subMenuRect
+                                                     : choiceMenuRect;
+    SDL_FRect bounds = UIHelper::getBorderRect(menuRect.x, menuRect.y,
+                                               menuRect.w, menuRect.h,
+                                               borderThickness);
+    renderRetained(renderer, bounds, [this]() { drawMenu(); });
+  }
+
+  void update(Interactable *interactable, Dialogue *dialogue) override {}
+
+  void handleEvents(const SDL_Event &event, const MouseInfo &mouseInfo) override {
+    // Open or close menu with escape
+    if (event.type == SDL_EVENT_KEY_DOWN && event.key.key == SDLK_ESCAPE) {
+      if (!show)
+        manager->trySetMenu(true);
+      else if (manager->isMenuActive() &&
+               (activeMenu->menuType == MenuType::Settings ||
+                activeMenu->menuType == MenuType::Choice) &&
+               mode == SelectMode::Item)
+        activeMenu = &menus["Main"]; // go back to the main menu
+      else if (manager->isMenuActive() &&
+               activeMenu->menuType == MenuType::Settings &&
+               mode == SelectMode::Option)
+        mode = SelectMode::Item; // go back to item selection
+      else
+        manager->trySetMenu(false);
+
+      show = manager->isMenuActive();
+    }
+
+    // Ignore other events if menu is inactive
+    if (!manager->isMenuActive())
+      return;
+
+    // Any input may change the selection or the menu shown
+    if (event.type == SDL_EVENT_KEY_DOWN ||
+        event.type == SDL_EVENT_MOUSE_WHEEL ||
+        mouseInfo.flags & SDL_BUTTON_LEFT)
+      markDirty();
+
+    // Get the selected menu and option items (need this to inform selection
+    // and scrolling)
+    auto *selectedMenu = getItemFromIndex<MenuItem>(
+        activeMenu->menuItems,
+        selectedItem
+    );
+    if (!selectedMenu)
+      return;
+    std::vector<OptionItem> *options = &selectedMenu->second.optionItems;
+
+    if (event.type == SDL_EVENT_KEY_DOWN) {
+      switch (event.key.key) {
+
+      // Button selection scrolling
+      //----------------------------------------------------------------------
+      case SDLK_UP:
+        if (mode == SelectMode::Item)
+          scroll(selectedItem,
+                 static_cast<int>(activeMenu->menuItems.size()),
+                 Scroll::Back);
+        break;
+
+      case SDLK_DOWN:
+        if (mode == SelectMode::Item)
+          scroll(selectedItem,
+                 static_cast<int>(activeMenu->menuItems.size()),
+                 Scroll::Forward);
+        break;
+
+      // Option item scrolling
+      //----------------------------------------------------------------------
+      case SDLK_LEFT:
+        if (mode == SelectMode::Option)
+          scroll(selectedMenu->second.selectedItem,
+                 static_cast<int>(options->size()), Scroll::Forward);
+        break;
+
+      case SDLK_RIGHT:
+        if (mode == SelectMode::Option)
+          scroll(selectedMenu->second.selectedItem,
+                 static_cast<int>(options->size()), Scroll::Back);
+        break;
+
+      // Item selection
+      //----------------------------------------------------------------------
+      case SDLK_RETURN: {
+        selectItem(selectedItem);
+        break;
+      }
+      default:
+        break;
+      }
+    } else if (event.type == SDL_EVENT_MOUSE_WHEEL) {
+      if (event.wheel.y > 0 && mode == SelectMode::Item) {
+        // Scroll UP
+        scroll(selectedItem,
+                static_cast<int>(activeMenu->menuItems.size()),
+                Scroll::Back);
+      } else if (event.wheel.y < 0 && mode == SelectMode::Item) {
+        // Scroll DOWN
+        scroll(selectedItem,
+                static_cast<int>(activeMenu->menuItems.size()),
+                Scroll::Forward);
+      } else if (event.wheel.y > 0 && mode == SelectMode::Option) {
+        // Scroll UP in option mode = scroll item RIGHT
+        scroll(selectedMenu->second.selectedItem,
+                static_cast<int>(options->size()), Scroll::Back);
+      } else if (event.wheel.y < 0 && mode == SelectMode::Option) {
+        // Scroll DOWN in option mode = scroll item LEFT
+        scroll(selectedMenu->second.selectedItem,
+                static_cast<int>(options->size()), Scroll::Forward);
+      }
+    }
+
+    // Select menu item if it was clicked on
+    SDL_FRect mousePos = {mouseInfo.xpos, mouseInfo.ypos, 1, 1};
+    if (mouseInfo.flags & SDL_BUTTON_LEFT) {
+      int idx = 0;
+      for (const auto& item : activeMenu->menuItems) {
+        if (item.second.buttonPos &&
+            Collision::AABB(*item.second.buttonPos, mousePos)) {
+          selectedItem = idx;
+          selectItem(idx);
+        }
+        ++idx;
+      }
+    }
+  }
+
+  void clean() override {
+    TextureManager::ReleaseTexture(selectIconTex);
+    selectIconTex = nullptr;
+  }
+
+private:
+  bool show = false;
+  IUIManager *manager;
+
+  SDL_FRect mainMenuRect = SDL_FRect(120.0f, 42.0f, 80.0f, 80.0f);
+  SDL_FRect subMenuRect = SDL_FRect(100.0f, 42.0f, 140.0f, 60.0f);
+  SDL_FRect choiceMenuRect = SDL_FRect(120.0f, 60.0f, 80.0f, 60.0f);
+
+  float borderThickness = 2.0f;
+  float pointsize = 14.0f;
+  float itemSpacing = 15.0f;
+  Margin const textOffset = {0.0f, 3.0f, 0.0f, 0.0f};
+  Size const buttonSize = {60.0f, 12.0f};
+
+  SDL_Color borderColour;
+  SDL_Color innerColour;
+  SDL_Color buttonColour;
+
+  SDL_Color textColour = {255, 255, 255};            // White
+  SDL_Color textSelectColour = {208, 199, 125};      // Yellow
+  SDL_Color buttonTextColour = {0, 0, 0};            // Black
+  SDL_Color buttonTextSelectColour = {104, 31, 31};  // Dark red
+
+  enum class MenuType { Main, Settings, Choice };
+  struct MenuItem; // Forward definition
+  struct Menu {
+    std::string headerText = "";
+    std::unordered_map<std::string, MenuItem> menuItems = {};
+    MenuType menuType = MenuType::Main;
+  };
+  struct OptionItem {
+    std::string name = "";
+    std::function<void(SDL_Renderer*, SDL_Window*)> function;
+    void selectItem(SDL_Renderer* ren, SDL_Window* win) {
+        if (function)
+            function(ren, win);
+    };
+    std::optional<SDL_FRect> buttonPos = std::nullopt;
+  };
+  struct MenuItem {
+    Menu *linkedMenu = nullptr;
+    std::vector<OptionItem> optionItems = {};
+    int selectedItem = -1;
+    std::optional<SDL_FRect> buttonPos = std::nullopt;
+  };
+  Menu *activeMenu;
+  std::unordered_map<std::string, Menu> menus = {};
+
+  // Item mode means we are selecting menu items
+  // Option mode means we are slecting options within items
+  enum class SelectMode { Item, Option };
+
+  // Back/forward scrolling handles both up/down and left/right scrolling
+  enum class Scroll { Back, Forward };
+  SelectMode mode = SelectMode::Item;
+  int selectedItem = 0;
+  OptionItem *itemSet = nullptr;
+
+  fs::path selectIconPath = fs::path(SDL_GetBasePath()) /
+                              "assets" / "textures" / "select_icon.png";
+  SDL_Texture *selectIconTex = nullptr;
+
+  // Helper method to element from index position in unordered_map
+  template<typename T>
+  std::pair<const std::string, T>* getItemFromIndex(std::unordered_map<std::string, T> &umap, int idx) {
+    if (idx >= umap.size())
+      return nullptr;
+
+    auto it = umap.begin();
+    std::advance(it, idx);
+
+    return &(*it);
+  }
+
+  // Draw whichever menu is active
+  void drawMenu() {
     if (show && activeMenu && activeMenu->menuType == MenuType::Main) {
       // Main menu
       //------------------------------------------------------------------------
@@ -403,199 +620,6 @@ public:
     }
   }
 
-  void update(Interactable *interactable, Dialogue *dialogue) override {}
-
-  void handleEvents(const SDL_Event &event, const MouseInfo &mouseInfo) override {
-    // Open or close menu with escape
-    if (event.type == SDL_EVENT_KEY_DOWN && event.key.key == SDLK_ESCAPE) {
-      if (!show)
-        manager->trySetMenu(true);
-      else if (manager->isMenuActive() &&
-               (activeMenu->menuType == MenuType::Settings ||
-                activeMenu->menuType == MenuType::Choice) &&
-               mode == SelectMode::Item)
-        activeMenu = &menus["Main"]; // go back to the main menu
-      else if (manager->isMenuActive() &&
-               activeMenu->menuType == MenuType::Settings &&
-               mode == SelectMode::Option)
-        mode = SelectMode::Item; // go back to item selection
-      else
-        manager->trySetMenu(false);
-
-      show = manager->isMenuActive();
-    }
-
-    // Ignore other events if menu is inactive
-    if (!manager->isMenuActive())
-      return;
-
-    // Get the selected menu and option items (need this to inform selection
-    // and scrolling)
-    auto *selectedMenu = getItemFromIndex<MenuItem>(
-        activeMenu->menuItems,
-        selectedItem
-    );
-    if (!selectedMenu)
-      return;
-    std::vector<OptionItem> *options = &selectedMenu->second.optionItems;
-
-    if (event.type == SDL_EVENT_KEY_DOWN) {
-      switch (event.key.key) {
-
-      // Button selection scrolling
-      //----------------------------------------------------------------------
-      case SDLK_UP:
-        if (mode == SelectMode::Item)
-          scroll(selectedItem,
-                 static_cast<int>(activeMenu->menuItems.size()),
-                 Scroll::Back);
-        break;
-
-      case SDLK_DOWN:
-        if (mode == SelectMode::Item)
-          scroll(selectedItem,
-                 static_cast<int>(activeMenu->menuItems.size()),
-                 Scroll::Forward);
-        break;
-
-      // Option item scrolling
-      //----------------------------------------------------------------------
-      case SDLK_LEFT:
-        if (mode == SelectMode::Option)
-          scroll(selectedMenu->second.selectedItem,
-                 static_cast<int>(options->size()), Scroll::Forward);
-        break;
-
-      case SDLK_RIGHT:
-        if (mode == SelectMode::Option)
-          scroll(selectedMenu->second.selectedItem,
-                 static_cast<int>(options->size()), Scroll::Back);
-        break;
-
-      // Item selection
-      //----------------------------------------------------------------------
-      case SDLK_RETURN: {
-        selectItem(selectedItem);
-        break;
-      }
-      default:
-        break;
-      }
-    } else if (event.type == SDL_EVENT_MOUSE_WHEEL) {
-      if (event.wheel.y > 0 && mode == SelectMode::Item) {
-        // Scroll UP
-        scroll(selectedItem,
-                static_cast<int>(activeMenu->menuItems.size()),
-                Scroll::Back);
-      } else if (event.wheel.y < 0 && mode == SelectMode::Item) {
-        // Scroll DOWN
-        scroll(selectedItem,
-                static_cast<int>(activeMenu->menuItems.size()),
-                Scroll::Forward);
-      } else if (event.wheel.y > 0 && mode == SelectMode::Option) {
-        // Scroll UP in option mode = scroll item RIGHT
-        scroll(selectedMenu->second.selectedItem,
-                static_cast<int>(options->size()), Scroll::Back);
-      } else if (event.wheel.y < 0 && mode == SelectMode::Option) {
-        // Scroll DOWN in option mode = scroll item LEFT
-        scroll(selectedMenu->second.selectedItem,
-                static_cast<int>(options->size()), Scroll::Forward);
-      }
-    }
-
-    // Select menu item if it was clicked on
-    SDL_FRect mousePos = {mouseInfo.xpos, mouseInfo.ypos, 1, 1};
-    if (mouseInfo.flags & SDL_BUTTON_LEFT) {
-      int idx = 0;
-      for (const auto& item : activeMenu->menuItems) {
-        if (item.second.buttonPos &&
-            Collision::AABB(*item.second.buttonPos, mousePos)) {
-          selectedItem = idx;
-          selectItem(idx);
-        }
-        ++idx;
-      }
-    }
-  }
-
-  void clean() override {
-    SDL_DestroyTexture(selectIconTex);
-  }
-
-private:
-  bool show = false;
-  IUIManager *manager;
-
-  SDL_FRect mainMenuRect = SDL_FRect(120.0f, 42.0f, 80.0f, 80.0f);
-  SDL_FRect subMenuRect = SDL_FRect(100.0f, 42.0f, 140.0f, 60.0f);
-  SDL_FRect choiceMenuRect = SDL_FRect(120.0f, 60.0f, 80.0f, 60.0f);
-
-  float borderThickness = 2.0f;
-  float pointsize = 14.0f;
-  float itemSpacing = 15.0f;
-  Margin const textOffset = {0.0f, 3.0f, 0.0f, 0.0f};
-  Size const buttonSize = {60.0f, 12.0f};
-
-  SDL_Color borderColour;
-  SDL_Color innerColour;
-  SDL_Color buttonColour;
-
-  SDL_Color textColour = {255, 255, 255};            // White
-  SDL_Color textSelectColour = {208, 199, 125};      // Yellow
-  SDL_Color buttonTextColour = {0, 0, 0};            // Black
-  SDL_Color buttonTextSelectColour = {104, 31, 31};  // Dark red
-
-  enum class MenuType { Main, Settings, Choice };
-  struct MenuItem; // Forward definition
-  struct Menu {
-    std::string headerText = "";
-    std::unordered_map<std::string, MenuItem> menuItems = {};
-    MenuType menuType = MenuType::Main;
-  };
-  struct OptionItem {
-    std::string name = "";
-    std::function<void(SDL_Renderer*, SDL_Window*)> function;
-    void selectItem(SDL_Renderer* ren, SDL_Window* win) {
-        if (function)
-            function(ren, win);
-    };
-    std::optional<SDL_FRect> buttonPos = std::nullopt;
-  };
-  struct MenuItem {
-    Menu *linkedMenu = nullptr;
-    std::vector<OptionItem> optionItems = {};
-    int selectedItem = -1;
-    std::optional<SDL_FRect> buttonPos = std::nullopt;
-  };
-  Menu *activeMenu;
-  std::unordered_map<std::string, Menu> menus = {};
-
-  // Item mode means we are selecting menu items
-  // Option mode means we are slecting options within items
-  enum class SelectMode { Item, Option };
-
-  // Back/forward scrolling handles both up/down and left/right scrolling
-  enum class Scroll { Back, Forward };
-  SelectMode mode = SelectMode::Item;
-  int selectedItem = 0;
-  OptionItem *itemSet = nullptr;
-
-  fs::path selectIconPath = fs::path(SDL_GetBasePath()) /
-                              "assets" / "textures" / "select_icon.png";
-  SDL_Texture *selectIconTex;
-
-  // Helper method to element from index position in unordered_map
-  template<typename T>
-  std::pair<const std::string, T>* getItemFromIndex(std::unordered_map<std::string, T> &umap, int idx) {
-    if (idx >= umap.size())
-      return nullptr;
-
-    auto it = umap.begin();
-    std::advance(it, idx);
-
-    return &(*it);
-  }
-
   // Helper method for scrolling
   void scroll(int &selected, int size, Scroll dir) {
     if (dir == Scroll::Forward && (selected + 1) >= size) {
@@ -21,11 +21,14 @@ public:
 
   void render(SDL_Renderer *renderer, SDL_Window *window) override {
     if (show) {
-      TextureManager::DrawPanel(borderRect, innerRect, borderColour,
-                                innerColour);
+      renderRetained(renderer, borderRect, [&]() {
+        TextureManager::DrawPanel(borderRect, innerRect, borderColour,
+                                  innerColour);
 
-      SDL_FRect srcRect = {0, 0, portraitRect.w, portraitRect.h};
-      TextureManager::Draw(portraitTex, srcRect, portraitRect, SDL_FLIP_NONE);
+        SDL_FRect srcRect = {0, 0, portraitRect.w, portraitRect.h};
+        TextureManager::Draw(portraitTex, srcRect, portraitRect,
+                             SDL_FLIP_NONE);
+      });
     }
   }
 
@@ -38,17 +41,22 @@ public:
       if (portrait != "" && portrait != lastPortrait) {
         std::string portraitPath = (texPath / dialogue->getPortrait()).string();
 
-        // Destroy previous texture
-        SDL_DestroyTexture(portraitTex);
-
-        // Create a new one
-        portraitTex = TextureManager::LoadTexture(portraitPath.c_str());
+        // Portraits are cached, so switching back and forth between
+        // speakers doesn't load them again
+        TextureManager::ReleaseTexture(portraitTex);
+        portraitTex = TextureManager::AcquireTexture(portraitPath);
+        lastPortrait = portrait;
+        markDirty();
       }
     } else
       show = false;
   }
 
-  void clean() override { SDL_DestroyTexture(portraitTex); }
+  void clean() override {
+    TextureManager::ReleaseTexture(portraitTex);
+    portraitTex = nullptr;
+    lastPortrait.clear();
+  }
 
 private:
   bool show = false;
@@ -61,5 +69,5 @@ private:
 
   fs::path texPath = fs::path(SDL_GetBasePath()) / "assets" / "textures";
   std::string lastPortrait;
-  SDL_Texture *portraitTex;
+  SDL_Texture *portraitTex = nullptr;
 };
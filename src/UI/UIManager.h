@@ -24,6 +24,9 @@ public:
     grid.addChild(std::make_shared<Options>(2.0f, menuBorderColour,
                                             dialogueBoxColour, menuBorderColour,
                                             pointsize, *this));
+
+    // Panels only redraw when what they show changes
+    grid.setRetained(true);
   }
   ~UIManager() { grid.clean(); }
 